@@ -1,13 +0,0 @@
-#include "AppState.h"
-
-namespace CurrencyConverter
-{
-	AppState::AppState()
-	{
-		this->account = Account();
-	}
-
-	AppState::~AppState()
-	{
-	}
-}
\ No newline at end of file
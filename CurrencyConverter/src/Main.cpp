@@ -16,34 +16,150 @@ int main(int argc, char* argv[])
 	// Instantiate AppState
 	CurrencyConverter::AppState app_state = CurrencyConverter::AppState();
 
+	// Benchmark of the rate update path. Needs no api key since it runs on made up rates.
+	if (argc >= 2 && std::string(argv[1]) == "--tick-bench")
+	{
+		return run_tick_bench_command(argc, argv);
+	}
+
+	// Turns audit log files back into text or csv
+	if (argc >= 2 && std::string(argv[1]).starts_with("--audit-decode="))
+	{
+		return run_audit_decode_command(argc, argv);
+	}
+
+	// Load test with a recorded session. Needs no api key since every response comes from the trace.
+	if (argc >= 2 && std::string(argv[1]).starts_with("--replay="))
+	{
+		return run_replay_command(argc, argv);
+	}
+
 	// Command line parameter parsing
 	if (argc < 2)
 	{
 		// No api key provided
 		std::cerr << "\nNo API KEY provided!\n";
-		std::cerr << "Usage: " << "CurrencyConverter.exe" << " <API_KEY>" << std::endl;
+		write_usage();
 		return 1;
 	}
-	if (argc > 2)
+
+	// Get api keys from command line arguments. Several keys are separated by commas.
+	app_state.api_keys.add_all(argv[1]);
+	if (app_state.api_keys.empty())
 	{
-		// Too many arguments
-		std::cerr << "\nToo many arguments provided!\n";
-		std::cerr << "Usage: " << "CurrencyConverter.exe" << " <API_KEY>" << std::endl;
+		std::cerr << "\nNo API KEY provided!\n";
+		write_usage();
 		return 1;
 	}
 
-	// Get api_key from command line arguments
-	app_state.api_key = argv[1];
-	app_state.currencies;
+	// Optional flags after the api key
+	bool publish_rates = false;
+	// Base currencies whose exchange rates get fetched at startup
+	std::vector<string> prefetch_bases {};
+	// Written with --record. Has to live as long as app_state uses it.
+	CurrencyConverter::TraceRecorder trace_recorder;
+	// Written with --audit. Its flusher stops when main returns.
+	CurrencyConverter::AuditLog audit_log;
+	for (int i = 2; i < argc; i++)
+	{
+		std::string argument = argv[i];
+		if (argument == "--publish")
+		{
+			// Share the rate table with other processes on this machine
+			publish_rates = true;
+		}
+		else if (argument.starts_with("--api-url="))
+		{
+			// E.g. a local stand-in server for testing
+			app_state.api_url = argument.substr(strlen("--api-url="));
+		}
+		else if (argument.starts_with("--prefetch="))
+		{
+			// Comma separated list of currency codes
+			std::stringstream codes(argument.substr(strlen("--prefetch=")));
+			std::string code = "";
+			while (getline(codes, code, ','))
+			{
+				if (!code.empty())
+				{
+					prefetch_bases.push_back(code);
+				}
+			}
+		}
+		else if (argument.starts_with("--windows="))
+		{
+			// Comma separated windows of the rate statistics, e.g. 1h,1d,30d
+			std::stringstream texts(argument.substr(strlen("--windows=")));
+			std::string text = "";
+			std::vector<int64_t> windows {};
+			while (getline(texts, text, ','))
+			{
+				int64_t seconds = 0;
+				if (!CurrencyConverter::parse_window(text, seconds))
+				{
+					std::cerr << "\nInvalid window: " << text << "\n";
+					write_usage();
+					return 1;
+				}
+				windows.push_back(seconds);
+			}
+			app_state.rate_analytics.set_windows(windows);
+		}
+		else if (argument.starts_with("--record="))
+		{
+			// Commands and api responses of this session get written to a trace file for --replay
+			std::string trace_path = argument.substr(strlen("--record="));
+			if (!trace_recorder.open(trace_path))
+			{
+				std::cerr << "\nCould not create trace file: " << trace_path << "\n";
+				return 1;
+			}
+			app_state.trace_recorder = &trace_recorder;
+		}
+		else if (argument.starts_with("--audit="))
+		{
+			// Every conversion gets recorded in rotating files in this directory
+			CurrencyConverter::AuditLogOptions audit_options = CurrencyConverter::AuditLogOptions();
+			audit_options.directory = argument.substr(strlen("--audit="));
+			if (!audit_log.open(audit_options))
+			{
+				std::cerr << "\nCould not create audit log in: " << audit_options.directory << "\n";
+				return 1;
+			}
+			app_state.audit_log = &audit_log;
+		}
+		else
+		{
+			std::cerr << "\nUnknown argument: " << argument << "\n";
+			write_usage();
+			return 1;
+		}
+	}
 
 	try
 	{
-		// Checks availability of API endpoint status.
-		// If status is available then the account data gets written to app_state->account.
-		check_api_status(app_state);
+		// In publisher mode the rate table lives in shared memory for as long as this program runs.
+		if (publish_rates)
+		{
+			if (!app_state.rate_table.open_shared())
+			{
+				std::cerr << "\n\tCould not create the shared rate table! Maybe another publisher is already running." << "\n";
+				return EXIT_FAILURE;
+			}
+			// Rates of a single base currency are enough for readers to derive every other pair.
+			if (std::find(prefetch_bases.begin(), prefetch_bases.end(), "USD") == prefetch_bases.end())
+			{
+				prefetch_bases.push_back("USD");
+			}
+		}
 
-		// Get available currencies here for the first time since they will be needed in any case
-		get_currencies(app_state);
+		// Checks availability of API endpoint status and gets the available currencies since they will be needed in any case.
+		// Exchange rates of the prefetched base currencies are requested at the same time.
+		{
+			CurrencyConverter::AllocationScope allocation_scope(CurrencyConverter::AllocationTag::Startup);
+			CurrencyConverter::record_event(app_state, CurrencyConverter::TraceEventType::Start, prefetch_bases);
+			CurrencyConverter::start_up(app_state, prefetch_bases);
+		}
 
 		// ---------- Program loop ----------
 		
@@ -58,6 +174,7 @@ int main(int argc, char* argv[])
 			// handle input
 			if (input == "A" || input == "a")
 			{
+				CurrencyConverter::record_event(app_state, CurrencyConverter::TraceEventType::List);
 				list_available_currencies(app_state);
 			}
 			if (input == "B" || input == "b")
@@ -68,6 +185,15 @@ int main(int argc, char* argv[])
 			{
 				exchange_money(app_state);
 			}
+			if (input == "R" || input == "r")
+			{
+				CurrencyConverter::record_event(app_state, CurrencyConverter::TraceEventType::Refresh);
+				CurrencyConverter::refresh_data(app_state);
+			}
+			if (input == "S" || input == "s")
+			{
+				write_rate_statistics(app_state);
+			}
 			if (input == "H" || input == "h")
 			{
 				write_help_menu();
@@ -82,96 +208,173 @@ int main(int argc, char* argv[])
 			getline(std::cin, input);
 		}
 	}
+	// The core reports errors like a rejected last api key as "new std::runtime_error(...)"
+	catch (std::runtime_error* e)
+	{
+		std::cerr << e->what() << '\n' << std::endl;
+		delete e;
+		return EXIT_FAILURE;
+	}
 	catch (std::exception& e)
 	{
 		std::cerr << e.what() << '\n' << std::endl;
 		return EXIT_FAILURE;
 	}
 
+	// Only prints something in the instrumented build
+	if (CurrencyConverter::allocation_tracking_enabled())
+	{
+		CurrencyConverter::write_allocation_summary(std::cout);
+	}
+
 	std::cout << "\n\n";
 	return EXIT_SUCCESS;
 }
 
-// This function fetches all exchange rates for a given currency
-// The currency is defined by it's currency code
-// All exchange rates will be fetched to reduce the number of api calls
-void get_exchange_rates(CurrencyConverter::AppState& app_state, CurrencyConverter::Currency& currency)
+// This function writes how the program gets started to the console
+void write_usage()
 {
-	// Class that handles memory initialization and deletion.
-	curlpp::Cleanup cleaner;
-
-	// Set target url of request to the status endpoint.
-	curlpp::Easy request;
-	request.setOpt(new Url("https://api.freecurrencyapi.com/v1/latest"));
-
-	// Add headers. Here this is the api key and the currency.
-	std::list<string> headers {};
-	headers.push_back("apikey: " + app_state.api_key);
-	headers.push_back("base_currency: " + currency.code);
-	request.setOpt(new HttpHeader(headers));
-
-	// Memory location to store the incoming response body
-	std::stringstream response_body;
-	// Set the response stream as output stream of the request
-	request.setOpt(cURLpp::Options::WriteStream(&response_body));
+	std::cerr << "Usage: " << "CurrencyConverter.exe" << " <API_KEY>[,<API_KEY>...] [--publish] [--prefetch=EUR,USD,...] [--api-url=http://localhost:8080/v1] [--windows=1h,1d,30d] [--record=session.cctr] [--audit=audit]" << '\n';
+	std::cerr << "       " << "CurrencyConverter.exe" << " --tick-bench [--currencies=32] [--ticks-per-second=100000] [--readers=4] [--seconds=5] [--audit=audit] [--analytics]" << '\n';
+	std::cerr << "       " << "CurrencyConverter.exe" << " --replay=session.cctr [--speed=1] [--users=1] [--repeat=1]" << '\n';
+	std::cerr << "       " << "CurrencyConverter.exe" << " --audit-decode=audit [--csv]" << std::endl;
+}
 
-	// Send request and get a result.
-	request.perform();
+// This function runs the synthetic rate tick benchmark with the options given on the command line and prints its report
+int run_tick_bench_command(int argc, char* argv[])
+{
+	CurrencyConverter::TickBenchOptions options = CurrencyConverter::TickBenchOptions();
+	for (int i = 2; i < argc; i++)
+	{
+		std::string argument = argv[i];
+		// Numbers that can't be parsed make stoul and friends throw
+		try
+		{
+			if (argument.starts_with("--currencies="))
+			{
+				options.currency_count = (uint32_t)std::stoul(argument.substr(strlen("--currencies=")));
+			}
+			else if (argument.starts_with("--ticks-per-second="))
+			{
+				// 0 runs the writer as fast as it can
+				options.ticks_per_second = std::stoull(argument.substr(strlen("--ticks-per-second=")));
+			}
+			else if (argument.starts_with("--readers="))
+			{
+				options.reader_count = (uint32_t)std::stoul(argument.substr(strlen("--readers=")));
+			}
+			else if (argument.starts_with("--seconds="))
+			{
+				options.seconds = std::stod(argument.substr(strlen("--seconds=")));
+			}
+			else if (argument.starts_with("--audit="))
+			{
+				// Readers write every conversion to an audit log, to see what that costs
+				options.audit_directory = argument.substr(strlen("--audit="));
+			}
+			else if (argument == "--analytics")
+			{
+				// The writer keeps statistics of every pair, like the interactive program does
+				options.analytics = true;
+			}
+			else
+			{
+				std::cerr << "\nUnknown argument: " << argument << "\n";
+				write_usage();
+				return 1;
+			}
+		}
+		catch (std::exception&)
+		{
+			std::cerr << "\nInvalid argument: " << argument << "\n";
+			write_usage();
+			return 1;
+		}
+	}
 
-	long response_code = curlpp::infos::ResponseCode::get(request);
+	// The report holds several histograms and is too big for the stack
+	std::unique_ptr<CurrencyConverter::TickBenchReport> report = std::make_unique<CurrencyConverter::TickBenchReport>();
+	CurrencyConverter::run_tick_bench(options, *report);
+	CurrencyConverter::write_tick_bench_report(std::cout, *report);
+	return EXIT_SUCCESS;
+}
 
-	// Handling the possible response codes.
-	// Error 403 (Not allowed), 422 (Validation Error) can't / shouldn't happen at this endpoint.
-	// Error 404 may happen if the url got changed.
-	switch (response_code)
+// This function replays a recorded session trace with the options given on the command line and prints its report
+int run_replay_command(int argc, char* argv[])
+{
+	CurrencyConverter::ReplayOptions options = CurrencyConverter::ReplayOptions();
+	options.path = std::string(argv[1]).substr(strlen("--replay="));
+	for (int i = 2; i < argc; i++)
 	{
-		// Happy case. Write received data to AppState and return.
-		// Curly braces are needed so that a scope is properly created and memory can be properly initialized and deleted
-		case 200:
+		std::string argument = argv[i];
+		// Numbers that can't be parsed make stoul and friends throw
+		try
+		{
+			if (argument.starts_with("--speed="))
 			{
-				// Example response body
-				// {"meta":{"last_updated_at":"2022-01-01T23:59:59Z"},"data":{"AED":3.67306,"AFN":91.80254,"ALL":108.22904,"AMD":480.41659,"...":"150+ more currencies"}}
+				// 0 runs the commands back to back without waiting
+				options.speed = std::stod(argument.substr(strlen("--speed=")));
+			}
+			else if (argument.starts_with("--users="))
+			{
+				options.user_count = (uint32_t)std::stoul(argument.substr(strlen("--users=")));
+			}
+			else if (argument.starts_with("--repeat="))
+			{
+				options.repeat_count = (uint32_t)std::stoul(argument.substr(strlen("--repeat=")));
+			}
+			else
+			{
+				std::cerr << "\nUnknown argument: " << argument << "\n";
+				write_usage();
+				return 1;
+			}
+		}
+		catch (std::exception&)
+		{
+			std::cerr << "\nInvalid argument: " << argument << "\n";
+			write_usage();
+			return 1;
+		}
+	}
 
-				// Parse response body
-				auto parsed_body = json::parse(response_body);
+	// The report holds several histograms and is too big for the stack
+	std::unique_ptr<CurrencyConverter::ReplayReport> report = std::make_unique<CurrencyConverter::ReplayReport>();
+	if (!CurrencyConverter::run_replay(options, *report))
+	{
+		std::cerr << "\nCould not read trace file: " << options.path << "\n";
+		return EXIT_FAILURE;
+	}
+	CurrencyConverter::write_replay_report(std::cout, *report);
+	return EXIT_SUCCESS;
+}
 
-				// Iterating over available currencies to get the key with which the parsed json gets accessed.
-				for (auto element : app_state.currencies)
-				{
-					std::string code = element.first;
-					float_t rate = parsed_body["data"][code];
-					
-					currency.exchange_rates[code] = rate;
-				}
+// This function writes the audit log file (or directory of files) given on the command line as text or csv to the console
+int run_audit_decode_command(int argc, char* argv[])
+{
+	std::string path = std::string(argv[1]).substr(strlen("--audit-decode="));
+	CurrencyConverter::AuditFormat format = CurrencyConverter::AuditFormat::Text;
+	for (int i = 2; i < argc; i++)
+	{
+		std::string argument = argv[i];
+		if (argument == "--csv")
+		{
+			format = CurrencyConverter::AuditFormat::Csv;
+		}
+		else
+		{
+			std::cerr << "\nUnknown argument: " << argument << "\n";
+			write_usage();
+			return 1;
+		}
+	}
 
-				// Update the used and reamining quotas since a successful query was made
-				app_state.account.quotas.used += 1;
-				app_state.account.quotas.remaining -= 1;
-				return;
-			}
-			// Invalid api key. This should trigger a program termination.
-		case 401:
-			std::cerr << "\n\n\tInvalid API key! Please check your key." << "\n";
-			throw new std::runtime_error("Invalid API key!");
-		// Endpoint doesn't exist. This should trigger a program termination.
-		case 404:
-			std::cerr << "\n\n\tLatest exchange rate API endpoint doesn't exist anymore! Please check the api documentation for changes." << "\n";
-			throw new std::runtime_error("Latest API endpoint doesn't exist!");
-		// Used up all quotas
-		case 429:
-			std::cerr << "\n\n\tYou have reached your rate limit! Try again next month or upgrade your plan." << "\n";
-			throw new std::runtime_error("Rate limit reached!");
-		// Some kind of server error. This should trigger a retry or a program termination if enough retrys are reached.
-		case 500:
-			// No retry here since the status endpoint worked at program initialization.
-			// So just terminate the program.
-			std::cerr << "\n\n\tServer error! Terminating program. Please try again later." << "\n";
-			throw new std::runtime_error("Latest API endpoint not reachable!");
-		// Any other unexpected response code. This should trigger a program termination.
-		default:
-			std::cerr << "\n\n\tUnexpected error!" << "\n";
-			throw new std::runtime_error("Unexpected error!");
+	if (!CurrencyConverter::decode_audit_log(path, std::cout, format))
+	{
+		std::cerr << "\nNot an audit log: " << path << "\n";
+		return EXIT_FAILURE;
 	}
+	return EXIT_SUCCESS;
 }
 
 // This function lets the user exchange money from a chosen source currency into an chosen target currency
@@ -179,11 +382,14 @@ void get_exchange_rates(CurrencyConverter::AppState& app_state, CurrencyConverte
 // If the chosen source currencies has no cached exchange rate data then the data will be fetched from the API
 void exchange_money(CurrencyConverter::AppState& app_state)
 {
+	std::string input = "";
 	std::string source_currency = "";
 	std::string target_currency = "";
 	std::string amount = "";
-	float_t amount_f = 0.0;
-	float_t converted_amount = 0.0;
+	double amount_d = 0.0;
+	double converted_amount = 0.0;
+	// Shown above the prompt after an input that matched several currencies
+	std::string suggestions = "";
 
 	// Ask for source currency
 	while (true)
@@ -192,23 +398,29 @@ void exchange_money(CurrencyConverter::AppState& app_state)
 		write_main_menu(app_state);
 		std::cout << "\nWhat do you want to do --> C";
 		std::cout << "\n---------- Money exchange ----------\n";
-		std::cout << "Please enter the currency code of the source currency. Then the currency code of the target currency and finally the amount.\n";
+		std::cout << "Please enter the source currency. Then the target currency and finally the amount.\n";
+		std::cout << "Currencies can be entered by code, name or symbol, e.g. \"CHF\", \"swiss franc\" or \"$\".\n";
 		std::cout << "If you make an invalid input then your input will be ignored and this window will be refreshed.\n\n";
+		std::cout << suggestions;
 		std::cout << "Source currency -> ";
 
-		getline(std::cin, source_currency);
+		getline(std::cin, input);
 
-		if (app_state.currencies.contains(source_currency))
+		// Names and symbols are fine as long as they clearly identify one currency
+		source_currency = app_state.currencies.contains(input) ? input : app_state.currency_search.resolve(input);
+		if (!source_currency.empty())
 		{
 			break;
 		}
+		suggestions = get_search_suggestions(app_state, input);
 	}
+	suggestions = "";
 
 	// Check if exchange rate data exist for source currency
 	// If not the fetch it
 	if (app_state.currencies[source_currency].exchange_rates.empty())
 	{
-		get_exchange_rates(app_state, app_state.currencies[source_currency]);
+		CurrencyConverter::get_exchange_rates(app_state, app_state.currencies[source_currency]);
 	}
 
 	// Ask for target currency
@@ -218,18 +430,22 @@ void exchange_money(CurrencyConverter::AppState& app_state)
 		write_main_menu(app_state);
 		std::cout << "\nWhat do you want to do --> C";
 		std::cout << "\n---------- Money exchange ----------\n";
-		std::cout << "Please enter the currency code of the source currency. Then the currency code of the target currency and finally the amount.\n";
+		std::cout << "Please enter the source currency. Then the target currency and finally the amount.\n";
+		std::cout << "Currencies can be entered by code, name or symbol, e.g. \"CHF\", \"swiss franc\" or \"$\".\n";
 		std::cout << "If you make an invalid input then your input will be ignored and this window will be refreshed.\n\n";
 		std::cout << "Source currency -> " << source_currency << '\n';
+		std::cout << suggestions;
 		std::cout << "Target currency -> ";
 
-		getline(std::cin, target_currency);
+		getline(std::cin, input);
+		target_currency = app_state.currencies.contains(input) ? input : app_state.currency_search.resolve(input);
 
 		// Check if the target currency exist in currencies
 		if (app_state.currencies[source_currency].exchange_rates.contains(target_currency))
 		{
 			break;
 		}
+		suggestions = target_currency.empty() ? get_search_suggestions(app_state, input) : "No exchange rate from " + source_currency + " to " + target_currency + ".\n";
 	}
 
 	// Ask for amount
@@ -239,7 +455,8 @@ void exchange_money(CurrencyConverter::AppState& app_state)
 		write_main_menu(app_state);
 		std::cout << "\nWhat do you want to do --> C";
 		std::cout << "\n---------- Money exchange ----------\n";
-		std::cout << "Please enter the currency code of the source currency. Then the currency code of the target currency and finally the amount.\n";
+		std::cout << "Please enter the source currency. Then the target currency and finally the amount.\n";
+		std::cout << "Currencies can be entered by code, name or symbol, e.g. \"CHF\", \"swiss franc\" or \"$\".\n";
 		std::cout << "If you make an invalid input then your input will be ignored and this window will be refreshed.\n\n";
 		std::cout << "Source currency -> " << source_currency << '\n';
 		std::cout << "Target currency -> " << target_currency << '\n';
@@ -247,23 +464,153 @@ void exchange_money(CurrencyConverter::AppState& app_state)
 
 		getline(std::cin, amount);
 
-		// Check if a number was entered by casting it to double and checking the result
-		// If the result is 0 then the input is invalid
-		// A 0 input will be invlaid as well but that's fine because that calculation is pointless
-		amount_f = atof(amount.c_str());
-		if (amount_f)
+		// Check if a valid number was entered. Grouping separators like in "1,000.50" are fine.
+		// A 0 input will be invalid as well because that calculation is pointless
+		if (CurrencyConverter::parse_amount(amount, amount_d) == CurrencyConverter::ParseAmountResult::Ok && amount_d != 0.0)
 		{
 			break;
 		}
 	}
 
+	// Ask for the rate. Some contracts settle at the average rate of a window instead of the latest one.
+	std::string rate_window = "";
+	int64_t twap_window = 0;
+	const std::vector<int64_t>& windows = app_state.rate_analytics.get_windows();
+	std::string missing_average = "";
+	while (true)
+	{
+		write_main_menu(app_state);
+		std::cout << "\nWhat do you want to do --> C";
+		std::cout << "\n---------- Money exchange ----------\n";
+		std::cout << "Please enter the source currency. Then the target currency and finally the amount.\n";
+		std::cout << "Currencies can be entered by code, name or symbol, e.g. \"CHF\", \"swiss franc\" or \"$\".\n";
+		std::cout << "If you make an invalid input then your input will be ignored and this window will be refreshed.\n\n";
+		std::cout << "Source currency -> " << source_currency << '\n';
+		std::cout << "Target currency -> " << target_currency << '\n';
+		std::cout << "Amount to be exchanged -> " << amount << '\n';
+		std::cout << missing_average;
+		std::cout << "Rate (press enter for the latest rate or type";
+		for (auto window : windows)
+		{
+			std::cout << ' ' << CurrencyConverter::format_window(window);
+		}
+		std::cout << " for the time weighted average of that window) -> ";
+
+		getline(std::cin, rate_window);
+		if (rate_window.empty())
+		{
+			twap_window = 0;
+			break;
+		}
+		if (CurrencyConverter::parse_window(rate_window, twap_window) && std::find(windows.begin(), windows.end(), twap_window) != windows.end())
+		{
+			// "24h" and "1d" are the same window
+			rate_window = CurrencyConverter::format_window(twap_window);
+			// convert_money() can't convert without an average
+			CurrencyConverter::RateStatistics statistics {};
+			if (app_state.rate_analytics.get_statistics(source_currency, target_currency, twap_window, app_state.now(), statistics))
+			{
+				break;
+			}
+			missing_average = "No " + rate_window + " average rate from " + source_currency + " to " + target_currency + " yet.\n";
+		}
+	}
+
 	// Do conversion and output result
-	converted_amount = amount_f * app_state.currencies[source_currency].exchange_rates[target_currency];
+	converted_amount = CurrencyConverter::convert_money(app_state, source_currency, target_currency, amount_d, twap_window);
+	if (twap_window > 0)
+	{
+		CurrencyConverter::record_event(app_state, CurrencyConverter::TraceEventType::Convert, { source_currency, target_currency, rate_window }, amount_d);
+	}
+	else
+	{
+		CurrencyConverter::record_event(app_state, CurrencyConverter::TraceEventType::Convert, { source_currency, target_currency }, amount_d);
+	}
+
+	CurrencyConverter::AllocationScope allocation_scope(CurrencyConverter::AllocationTag::Render);
+
+	// Both amounts are written with the symbol and decimal digits of their currency
+	char source_text[128];
+	char target_text[128];
+	size_t source_length = CurrencyConverter::format_money(source_text, sizeof(source_text), amount_d, app_state.currencies[source_currency].money_format);
+	size_t target_length = CurrencyConverter::format_money(target_text, sizeof(target_text), converted_amount, app_state.currencies[target_currency].money_format);
 
-	std::cout << amount_f;
-	std::cout << std::setw(4) << app_state.currencies[source_currency].symbol;
-	std::cout << " is " << converted_amount;
-	std::cout << std::setw(4) << app_state.currencies[target_currency].symbol;
+	std::cout.write(source_text, (std::streamsize)source_length);
+	std::cout << " is ";
+	std::cout.write(target_text, (std::streamsize)target_length);
+	if (twap_window > 0)
+	{
+		std::cout << " at the " << rate_window << " average rate";
+	}
+	std::cout << '\n';
+}
+
+// This function asks for a currency. Returns its code.
+std::string ask_for_currency(CurrencyConverter::AppState& app_state, const std::string& prompt)
+{
+	std::string input = "";
+	while (true)
+	{
+		std::cout << prompt;
+		getline(std::cin, input);
+		std::string code = app_state.currencies.contains(input) ? input : app_state.currency_search.resolve(input);
+		if (!code.empty())
+		{
+			return code;
+		}
+		std::string suggestions = get_search_suggestions(app_state, input);
+		std::cout << (suggestions.empty() ? "Unrecognized currency. Please try again.\n" : suggestions);
+	}
+}
+
+// This function lists the currencies that match the input equally well, e.g. for "$". Empty if nothing matches.
+std::string get_search_suggestions(CurrencyConverter::AppState& app_state, const std::string& input)
+{
+	std::vector<CurrencyConverter::SearchMatch> matches = app_state.currency_search.search(input);
+	if (matches.empty())
+	{
+		return "";
+	}
+	std::string suggestions = "Did you mean:";
+	for (auto& match : matches)
+	{
+		suggestions += " " + match.code + " (" + app_state.currencies[match.code].name + ")";
+	}
+	return suggestions + "\n";
+}
+
+// This function lets the user choose a pair and shows the latest rate with its statistics over every window
+void write_rate_statistics(CurrencyConverter::AppState& app_state)
+{
+	std::cout << "\n---------- Rate statistics ----------" << '\n';
+	std::string source_currency = ask_for_currency(app_state, "Source currency -> ");
+	std::string target_currency = ask_for_currency(app_state, "Target currency -> ");
+	CurrencyConverter::record_event(app_state, CurrencyConverter::TraceEventType::Statistics, { source_currency, target_currency });
+
+	// Statistics only start with the first fetched rates
+	if (app_state.currencies[source_currency].exchange_rates.empty())
+	{
+		CurrencyConverter::get_exchange_rates(app_state, app_state.currencies[source_currency]);
+	}
+
+	CurrencyConverter::AllocationScope allocation_scope(CurrencyConverter::AllocationTag::Render);
+
+	int64_t now = app_state.now();
+	CurrencyConverter::RateStatistics statistics {};
+	std::cout << '\n' << source_currency << " -> " << target_currency << '\n';
+	for (auto window : app_state.rate_analytics.get_windows())
+	{
+		std::cout << std::format("{:>5}  ", CurrencyConverter::format_window(window));
+		if (!app_state.rate_analytics.get_statistics(source_currency, target_currency, window, now, statistics))
+		{
+			std::cout << "no rates yet" << '\n';
+			continue;
+		}
+		std::cout << std::format("spot {:.6f}  TWAP {:.6f}  min {:.6f}  max {:.6f}  volatility {:.4f}%  ({} updates, {} covered)",
+			statistics.spot, statistics.twap, statistics.min, statistics.max, statistics.volatility * 100.0,
+			statistics.samples, CurrencyConverter::format_window(statistics.covered_seconds > 0 ? statistics.covered_seconds : 1)) << '\n';
+	}
+	std::cout << "Statistics cover the rates this program has seen since it started." << '\n';
 }
 
 // This function lets the user choose a currency and displays detailed information about it
@@ -273,26 +620,40 @@ void write_detailed_currency_information(CurrencyConverter::AppState& app_state)
 	while (true)
 	{
 		std::cout << "\n---------- Detailed currency information ----------" << '\n';
-		std::cout << "Please type in the code of the currency you wish to know more about -> ";
+		std::cout << "Please type in the code, name or symbol of the currency you wish to know more about -> ";
 		getline(std::cin, input);
 
-		if (app_state.currencies.contains(input))
+		std::string code = app_state.currencies.contains(input) ? input : app_state.currency_search.resolve(input);
+		if (!code.empty())
 		{
-			app_state.currencies[input].print();
+			// The typed text gets recorded so that a replay searches for it as well
+			CurrencyConverter::record_event(app_state, CurrencyConverter::TraceEventType::Lookup, { input });
+			CurrencyConverter::AllocationScope allocation_scope(CurrencyConverter::AllocationTag::Render);
+			app_state.currencies[code].print();
 			break;
 		}
 
-		std::cout << "Unrecognized currency code. Please try again.";
+		// Several currencies match equally well. Let the user pick one of them.
+		std::string suggestions = get_search_suggestions(app_state, input);
+		if (!suggestions.empty())
+		{
+			std::cout << suggestions;
+			continue;
+		}
+
+		std::cout << "Unrecognized currency. Please try again.";
 	}
 }
 
 // This function write all currencies stored in app_state.currencies to the console
 void list_available_currencies(CurrencyConverter::AppState& app_state)
 {
+	CurrencyConverter::AllocationScope allocation_scope(CurrencyConverter::AllocationTag::Render);
+
 	std::cout << "Available currencies:" << '\n';
 	for (auto currency : app_state.currencies)
 	{
-		std::cout << "    " << currency.first << std::endl;
+		std::cout << "    " << currency.first << '\n';
 	}
 }
 
@@ -310,6 +671,14 @@ void write_help_menu()
 	// Explain option C
 	std::cout << "Exchange money -> " << '\n';
 	std::cout << "    This option lets you convert a chosen amount from your source currency into your target currency." << '\n';
+	// Explain option R
+	std::cout << "Refresh currencies and exchange rates -> " << '\n';
+	std::cout << "    This option checks the API for a new currency list and new exchange rates of all cached currencies." << '\n';
+	std::cout << "    Only data that changed gets downloaded. Exchange rates are only published once a day, so younger ones aren't requested at all." << '\n';
+	// Explain option S
+	std::cout << "Show rate statistics of a pair -> " << '\n';
+	std::cout << "    This option shows the latest rate of a pair with its time weighted average, minimum, maximum and volatility over the last hour, day and 30 days." << '\n';
+	std::cout << "    The averages can also be used as the rate of a money exchange." << '\n';
 	// Explain option H
 	std::cout << "Show help -> " << '\n';
 	std::cout << "    This option shows you this help menu." << '\n';
@@ -321,218 +690,27 @@ void write_help_menu()
 // This function writes the main menu contents to the console
 void write_main_menu(CurrencyConverter::AppState& app_state)
 {
+	CurrencyConverter::AllocationScope allocation_scope(CurrencyConverter::AllocationTag::Render);
+
 	// Clear console
 	system("cls");
 	// Display account data
-	std::cout << "\n--------------------------------\n" << app_state.account.to_string() << "--------------------------------\n";
+	std::cout << "\n--------------------------------\n";
+	for (auto& api_key : app_state.api_keys.keys)
+	{
+		std::cout << api_key.to_string();
+	}
+	std::cout << "--------------------------------\n";
 	// Display options to choose
 	std::cout << "A -> List available currencies" << '\n';
 	std::cout << "B -> Show detailed information about a currency" << '\n';
 	std::cout << "C -> Exchange money" << '\n';
+	std::cout << "R -> Refresh currencies and exchange rates" << '\n';
+	std::cout << "S -> Show rate statistics of a pair" << '\n';
 	std::cout << "H -> Show help" << '\n';
 	std::cout << "X -> Close the program" << std::endl;
 }
 
-// This function loads the currency list into the app_state if needed.
-void get_currencies(CurrencyConverter::AppState& app_state, bool forced)
-{
-	// If this function isn't doing a forced update and currencies are already loaded
-	// then nothing needs to be done
-	if (!forced && !app_state.currencies.empty())
-	{
-		return;
-	}
-
-	// Fetch new data
-	// Class that handles memory initialization and deletion.
-	curlpp::Cleanup cleaner;
-
-	// Set target url of request to the status endpoint.
-	curlpp::Easy request;
-	request.setOpt(new Url("https://api.freecurrencyapi.com/v1/currencies"));
-
-	// Add headers. Here only containing the api key.
-	std::list<string> headers {};
-	headers.push_back("apikey: " + app_state.api_key);
-	request.setOpt(new HttpHeader(headers));
-
-	// Memory location to store the incoming response body
-	std::stringstream response_body;
-	// Set the response stream as output stream of the request
-	request.setOpt(cURLpp::Options::WriteStream(&response_body));
-
-	// Send request and get a result.
-	request.perform();
-
-	long response_code = curlpp::infos::ResponseCode::get(request);
-
-	// Handling the possible response codes.
-	// Error 403 (Not allowed), 422 (Validation Error) can't / shouldn't happen at this endpoint.
-	// Error 404 may happen if the url got changed.
-	switch (response_code)
-	{
-		// Happy case. Write received data to AppState and return.
-		// Curly braces are needed so that a scope is properly created and memory can be properly initialized and deleted
-		case 200:
-		{
-			// Example response body
-			// {"data":{"AED":{"symbol":"AED","name":"United Arab Emirates Dirham","symbol_native":"د.إ","decimal_digits":2,"rounding":0,"code":"AED","name_plural":"UAE dirhams"},"AFN":{"symbol":"Af","name":"Afghan Afghani","symbol_native":"؋","decimal_digits":0,"rounding":0,"code":"AFN","name_plural":"Afghan Afghanis"},"...":{}}}
-
-			// Parse response body
-			auto parsed_body = json::parse(response_body);
-
-			// Construct new currencies from parsed_body
-			for (auto& element : parsed_body["data"])
-			{
-				CurrencyConverter::Currency currency = CurrencyConverter::Currency(
-					element["symbol"],
-					element["name"],
-					element["symbol_native"],
-					element["decimal_digits"],
-					element["rounding"],
-					element["code"],
-					element["name_plural"]
-				);
-				std::string code = (string) element["code"];
-				app_state.currencies[code] = currency;
-			}
-
-			// Update the used and reamining quotas since a successful query was made
-			app_state.account.quotas.used += 1;
-			app_state.account.quotas.remaining -= 1;
-			return;
-		}
-		// Invalid api key. This should trigger a program termination.
-		case 401:
-			std::cerr << "\n\n\tInvalid API key! Please check your key." << "\n";
-			throw new std::runtime_error("Invalid API key!");
-		// Endpoint doesn't exist. This should trigger a program termination.
-		case 404:
-			std::cerr << "\n\n\tCurrency API endpoint doesn't exist anymore! Please check the api documentation for changes." << "\n";
-			throw new std::runtime_error("Currency API endpoint doesn't exist!");
-		// Used up all quotas
-		case 429:
-			std::cerr << "\n\n\tYou have reached your rate limit! Try again next month or upgrade your plan." << "\n";
-			throw new std::runtime_error("Rate limit reached!");
-		// Some kind of server error. This should trigger a retry or a program termination if enough retrys are reached.
-		case 500:
-			// No retry here since the status endpoint worked at program initialization.
-			// So just terminate the program.
-			std::cerr << "\n\n\tServer error! Terminating program. Please try again later." << "\n";
-			throw new std::runtime_error("Currency API endpoint not reachable!");
-		// Any other unexpected response code. This should trigger a program termination.
-		default:
-			std::cerr << "\n\n\tUnexpected error!" << "\n";
-			throw new std::runtime_error("Unexpected error!");
-	}
-}
-
-void check_api_status(CurrencyConverter::AppState& app_state)
-{
-	// Class that handles memory initialization and deletion.
-	curlpp::Cleanup cleaner;
-
-	// Set target url of request to the status endpoint.
-	curlpp::Easy request;
-	request.setOpt(new Url("https://api.freecurrencyapi.com/v1/status"));
-
-	// Add headers. Here only containing the api key.
-	std::list<string> headers {};
-	headers.push_back("apikey: " + app_state.api_key);
-
-	request.setOpt(new HttpHeader(headers));
-
-	// Memory location to store the incoming response body
-	std::stringstream response_body;
-	// Set the response stream as output stream of the request
-	request.setOpt(cURLpp::Options::WriteStream(&response_body));
-
-	// Counter necessary for retrying if the status endpoint fails with error 500
-	// Retry currently after 30 seconds for the case if the problem is intermittent
-	uint8_t retry_count {};
-	uint8_t max_retry_count { 5 };
-
-	while (true)
-	{
-		// Send request and get a result.
-		// By default the result goes to standard output.
-		request.perform();
-
-		long response_code = curlpp::infos::ResponseCode::get(request);
-		// std::cout << "\nDEBUG: response code --> " << response_code << "\n\n";
-
-		// Handling the possible response codes.
-		// Error 403 (Not allowed), 422 (Validation Error) and 429 (Rate Limit hit) can't / shouldn't happen at this endpoint.
-		// Error 404 may happen if the url got changed.
-		switch (response_code)
-		{
-			// Happy case. Write received data to AppState and return.
-			case 200:
-			{
-				// Example response body for freecurrencyapi.com
-				// {"account_id":239344465066725376,"quotas":{"month":{"total":5000,"used":0,"remaining":5000}}}
-				// Example response body for currencyapi.com
-				// {"account_id":239344465066725376,"quotas":{"month":{"total":5000,"used":0,"remaining":5000},"grace":{"total":0,"used":0,"remaining":0}}}
-
-				// Parse response body
-				auto parsed_body = json::parse(response_body);
-				// Fill account info with response data
-				for (auto& element : parsed_body)
-				{
-					// Extract data from json object to cast it readably
-					uint32_t account_id = (uint32_t)parsed_body["account_id"];
-					uint32_t total = (uint32_t)parsed_body["quotas"]["month"]["total"];
-					uint32_t used = (uint32_t)parsed_body["quotas"]["month"]["used"];
-					uint32_t remaining = (uint32_t)parsed_body["quotas"]["month"]["remaining"];
-
-					// Create account object without grace data since this function is fetching from freecurrencyapi.com
-					// which doesn't have grace options.
-					CurrencyConverter::Account account = CurrencyConverter::Account(
-						std::to_string(account_id),
-						total,
-						used,
-						remaining,
-						0, 0, 0
-					);
-
-					// Store account in th AppState so that it can be accessed outside
-					app_state.account = account;
-				}
-				return;
-			}
-			// Invalid api key. This should trigger a program termination.
-			case 401:
-				std::cerr << "\n\n\tInvalid API key! Please check your key." << "\n";
-				throw new std::runtime_error("Invalid API key!");
-			// Endpoint doesn't exist. This should trigger a program termination.
-			case 404:
-				std::cerr << "\n\n\tStatus API endpoint doesn't exist anymore! Please check the api documentation for changes." << "\n";
-				throw new std::runtime_error("Status API endpoint doesn't exist!");
-			// Some kind of server error. This should trigger a retry or a program termination if enough retrys are reached.
-			case 500:
-				// Check if retry or termination.
-				if (retry_count < max_retry_count)
-				{
-					// Retry
-					std::cerr << "\n\n\tStatus API endpoint not reachable or other server error. Automatic retry in 30 seconds." << "\n";
-					// Wait 30 seconds before restarting the loop.
-					// Sleep takes milliseconds as argument so seconds time 1000.
-					Sleep(30 * 1000);
-					continue;
-				} else
-				{
-					// Program termination
-					std::cerr << "\n\n\tMaximum retries reached. Terminating program. Please try again later." << "\n";
-					throw new std::runtime_error("Status API endpoint not reachable!");
-				}
-			// Any other unexpected response code. This should trigger a program termination.
-			default:
-				std::cerr << "\n\n\tUnexpected error!" << "\n";
-				throw new std::runtime_error("Unexpected error!");
-		}
-	}
-}
-
 void test_http_requests()
 {
 	try
@@ -3,7 +3,13 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <vector>
+#include <list>
+#include <future>
+#include <algorithm>
+#include <memory>
 #include <ctime>
+#include <format>
 #include <windows.h>
 #include <libloaderapi.h>
 
@@ -20,8 +26,13 @@
 #include <curlpp/Multi.hpp>
 #include <curlpp/OptionBase.hpp>
 
+// Core library (CurrencyConverterCore)
 #include "Currency.h"
 #include "AppState.h"
+#include "Core.h"
+#include "AllocationTracker.h"
+#include "TickBench.h"
+#include "ReplayDriver.h"
 
 
 using std::map;
@@ -32,14 +43,18 @@ using json = nlohmann::json;
 
 using CurrencyConverter::Currency;
 
-void get_exchange_rates(CurrencyConverter::AppState& app_state, CurrencyConverter::Currency& currency);
+void write_usage();
+int run_tick_bench_command(int argc, char* argv[]);
+int run_replay_command(int argc, char* argv[]);
+int run_audit_decode_command(int argc, char* argv[]);
 void exchange_money(CurrencyConverter::AppState& app_state);
 void write_detailed_currency_information(CurrencyConverter::AppState& app_state);
 void list_available_currencies(CurrencyConverter::AppState& app_state);
+std::string ask_for_currency(CurrencyConverter::AppState& app_state, const std::string& prompt);
+std::string get_search_suggestions(CurrencyConverter::AppState& app_state, const std::string& input);
+void write_rate_statistics(CurrencyConverter::AppState& app_state);
 void write_help_menu();
 void write_main_menu(CurrencyConverter::AppState& app_state);
-void get_currencies(CurrencyConverter::AppState& app_state, bool forced = false);
-void check_api_status(CurrencyConverter::AppState& app_state);
 
 // Some function that i used to learn how the external libraries get used
 void test_http_requests();
@@ -0,0 +1,461 @@
+#include "CurrencyConverterApi.h"
+#include <string>
+#include <vector>
+#include <sstream>
+#include <cstring>
+#include <cmath>
+#include <ctime>
+#include <memory>
+#include <algorithm>
+#include <stdexcept>
+
+#include "AppState.h"
+#include "Core.h"
+
+// The handle behind the opaque C type
+struct cc_converter {
+	CurrencyConverter::AppState app_state;
+	uint64_t conversion_count;
+	uint64_t failed_conversion_count;
+	uint64_t refresh_count;
+	// Only set after cc_open_audit_log()
+	std::unique_ptr<CurrencyConverter::AuditLog> audit_log;
+};
+
+namespace
+{
+	thread_local std::string last_error = "";
+
+	cc_status fail(cc_status status, const char* message)
+	{
+		last_error = message;
+		return status;
+	}
+
+	// Runs a call into the core and turns every exception into a status code.
+	// The core throws "new std::runtime_error(...)", curlpp and the json library throw by value.
+	template <typename Call>
+	cc_status guarded(cc_converter* converter, Call call)
+	{
+		try
+		{
+			return call();
+		}
+		catch (std::runtime_error* e)
+		{
+			last_error = e->what();
+			delete e;
+			if (converter != nullptr && converter->app_state.api_keys.active_count() == 0)
+			{
+				return CC_ERROR_NO_API_KEY;
+			}
+			return CC_ERROR_REQUEST_FAILED;
+		}
+		catch (std::exception& e)
+		{
+			last_error = e.what();
+			return CC_ERROR_REQUEST_FAILED;
+		}
+		catch (...)
+		{
+			last_error = "Unknown error";
+			return CC_ERROR_INTERNAL;
+		}
+	}
+
+	// Fetches the rates of the source currency unless they are cached already.
+	// Without a usable key that isn't possible. Expects to be called inside guarded().
+	cc_status fetch_source_rates(CurrencyConverter::AppState& app_state, CurrencyConverter::Currency& source)
+	{
+		if (!source.exchange_rates.empty())
+		{
+			return CC_OK;
+		}
+		if (app_state.api_keys.active_count() == 0)
+		{
+			return fail(CC_ERROR_NO_API_KEY, "No usable API key left");
+		}
+		CurrencyConverter::get_exchange_rates(app_state, source);
+		return CC_OK;
+	}
+
+	// Statistics of a pair whose rates are cached. cc_convert_at_twap() and cc_get_rate_statistics() fail the same way without them.
+	cc_status get_pair_statistics(CurrencyConverter::AppState& app_state, const std::string& source_code, const std::string& target_code, int64_t window_seconds, CurrencyConverter::RateStatistics& statistics)
+	{
+		const std::vector<int64_t>& windows = app_state.rate_analytics.get_windows();
+		if (std::find(windows.begin(), windows.end(), window_seconds) == windows.end())
+		{
+			return fail(CC_ERROR_INVALID_ARGUMENT, "Window isn't one of the configured windows");
+		}
+		if (!app_state.rate_analytics.get_statistics(source_code, target_code, window_seconds, app_state.now(), statistics))
+		{
+			return fail(CC_ERROR_NO_AVERAGE_RATE, "No rates of this pair in the window yet");
+		}
+		return CC_OK;
+	}
+
+	// Fetches the rates of the source currency if needed and converts.
+	// twap_window_seconds 0 converts with the latest rate. Expects to be called inside guarded().
+	cc_status convert_one(cc_converter* converter, const std::string& source_code, const std::string& target_code, double amount, int64_t twap_window_seconds, double& result)
+	{
+		CurrencyConverter::AppState& app_state = converter->app_state;
+
+		auto source = app_state.currencies.find(source_code);
+		if (source == app_state.currencies.end())
+		{
+			return fail(CC_ERROR_UNKNOWN_CURRENCY, "Unknown source currency");
+		}
+		cc_status fetched = fetch_source_rates(app_state, source->second);
+		if (fetched != CC_OK)
+		{
+			return fetched;
+		}
+		// Also catches currencies that were added by a refresh after the source rates were fetched
+		if (!source->second.exchange_rates.contains(target_code))
+		{
+			return fail(CC_ERROR_UNKNOWN_CURRENCY, "Unknown target currency");
+		}
+		if (twap_window_seconds > 0)
+		{
+			// Otherwise convert_money() throws and the failure would look like a failed request
+			CurrencyConverter::RateStatistics statistics {};
+			cc_status found = get_pair_statistics(app_state, source_code, target_code, twap_window_seconds, statistics);
+			if (found != CC_OK)
+			{
+				return found;
+			}
+		}
+
+		result = CurrencyConverter::convert_money(app_state, source_code, target_code, amount, twap_window_seconds);
+		return CC_OK;
+	}
+}
+
+uint32_t cc_abi_version(void)
+{
+	return CC_ABI_VERSION;
+}
+
+cc_status cc_init(const char* api_keys, const char* api_url, const char* prefetch_bases, cc_converter** converter)
+{
+	last_error = "";
+	if (converter == nullptr || api_keys == nullptr)
+	{
+		return fail(CC_ERROR_INVALID_ARGUMENT, "api_keys and converter must not be NULL");
+	}
+	*converter = nullptr;
+
+	cc_converter* created = new cc_converter();
+	created->conversion_count = 0;
+	created->failed_conversion_count = 0;
+	created->refresh_count = 0;
+
+	created->app_state.api_keys.add_all(api_keys);
+	if (created->app_state.api_keys.empty())
+	{
+		delete created;
+		return fail(CC_ERROR_INVALID_ARGUMENT, "No API key provided");
+	}
+	if (api_url != nullptr)
+	{
+		created->app_state.api_url = api_url;
+	}
+
+	std::vector<std::string> prefetch {};
+	if (prefetch_bases != nullptr)
+	{
+		std::stringstream codes(prefetch_bases);
+		std::string code = "";
+		while (getline(codes, code, ','))
+		{
+			if (!code.empty())
+			{
+				prefetch.push_back(code);
+			}
+		}
+	}
+
+	cc_status status = guarded(created, [&]() {
+		CurrencyConverter::start_up(created->app_state, prefetch);
+		return CC_OK;
+	});
+	if (status != CC_OK)
+	{
+		delete created;
+		return status;
+	}
+
+	*converter = created;
+	return CC_OK;
+}
+
+cc_status cc_refresh(cc_converter* converter)
+{
+	last_error = "";
+	if (converter == nullptr)
+	{
+		return fail(CC_ERROR_INVALID_ARGUMENT, "converter must not be NULL");
+	}
+
+	return guarded(converter, [&]() {
+		CurrencyConverter::refresh_data(converter->app_state);
+		converter->refresh_count++;
+		return CC_OK;
+	});
+}
+
+cc_status cc_convert(cc_converter* converter, const char* source_code, const char* target_code, double amount, double* result)
+{
+	return cc_convert_at_twap(converter, source_code, target_code, amount, 0, result);
+}
+
+cc_status cc_convert_at_twap(cc_converter* converter, const char* source_code, const char* target_code, double amount, int64_t window_seconds, double* result)
+{
+	last_error = "";
+	if (converter == nullptr || source_code == nullptr || target_code == nullptr || result == nullptr)
+	{
+		return fail(CC_ERROR_INVALID_ARGUMENT, "Arguments must not be NULL");
+	}
+	if (std::isnan(amount))
+	{
+		converter->failed_conversion_count++;
+		return fail(CC_ERROR_INVALID_ARGUMENT, "Amount is not a number");
+	}
+	if (window_seconds < 0)
+	{
+		converter->failed_conversion_count++;
+		return fail(CC_ERROR_INVALID_ARGUMENT, "Window must not be negative");
+	}
+
+	cc_status status = guarded(converter, [&]() {
+		return convert_one(converter, source_code, target_code, amount, window_seconds, *result);
+	});
+	if (status == CC_OK)
+	{
+		converter->conversion_count++;
+	}
+	else
+	{
+		converter->failed_conversion_count++;
+	}
+	return status;
+}
+
+cc_status cc_convert_batch(cc_converter* converter, cc_conversion* conversions, size_t count)
+{
+	last_error = "";
+	if (converter == nullptr || (conversions == nullptr && count > 0))
+	{
+		return fail(CC_ERROR_INVALID_ARGUMENT, "Arguments must not be NULL");
+	}
+
+	cc_status first_failure = CC_OK;
+	// Codes are at most 7 characters, short enough for the small string buffer, so these never allocate
+	std::string source_code = "";
+	std::string target_code = "";
+	for (size_t i = 0; i < count; i++)
+	{
+		cc_conversion& conversion = conversions[i];
+		source_code.assign(conversion.source_code, strnlen(conversion.source_code, sizeof(conversion.source_code)));
+		target_code.assign(conversion.target_code, strnlen(conversion.target_code, sizeof(conversion.target_code)));
+
+		cc_status status = CC_OK;
+		if (std::isnan(conversion.amount))
+		{
+			status = fail(CC_ERROR_INVALID_ARGUMENT, "Amount is not a number");
+		}
+		else
+		{
+			status = guarded(converter, [&]() {
+				return convert_one(converter, source_code, target_code, conversion.amount, 0, conversion.result);
+			});
+		}
+
+		conversion.status = status;
+		if (status == CC_OK)
+		{
+			converter->conversion_count++;
+			continue;
+		}
+		converter->failed_conversion_count++;
+		if (first_failure == CC_OK)
+		{
+			first_failure = status;
+		}
+	}
+	return first_failure;
+}
+
+cc_status cc_search_currencies(cc_converter* converter, const char* query, cc_search_result* results, size_t capacity, size_t* count)
+{
+	last_error = "";
+	if (converter == nullptr || query == nullptr || count == nullptr || (results == nullptr && capacity > 0))
+	{
+		return fail(CC_ERROR_INVALID_ARGUMENT, "Arguments must not be NULL");
+	}
+
+	return guarded(converter, [&]() {
+		std::vector<CurrencyConverter::SearchMatch> matches = converter->app_state.currency_search.search(query, capacity);
+		size_t written = 0;
+		for (auto& match : matches)
+		{
+			// A cut off code would name another currency or none
+			if (match.code.size() >= CC_CODE_SIZE)
+			{
+				continue;
+			}
+			results[written] = {};
+			match.code.copy(results[written].code, CC_CODE_SIZE - 1);
+			results[written].score = match.score;
+			written++;
+		}
+		*count = written;
+		return CC_OK;
+	});
+}
+
+cc_status cc_resolve_currency(cc_converter* converter, const char* query, char code[CC_CODE_SIZE])
+{
+	last_error = "";
+	if (converter == nullptr || query == nullptr || code == nullptr)
+	{
+		return fail(CC_ERROR_INVALID_ARGUMENT, "Arguments must not be NULL");
+	}
+
+	return guarded(converter, [&]() {
+		std::string resolved = converter->app_state.currency_search.resolve(query);
+		if (resolved.empty())
+		{
+			return fail(CC_ERROR_UNKNOWN_CURRENCY, "No currency or more than one matches the query");
+		}
+		if (resolved.size() >= CC_CODE_SIZE)
+		{
+			return fail(CC_ERROR_UNKNOWN_CURRENCY, "Currency code is longer than CC_CODE_SIZE allows");
+		}
+		memset(code, 0, CC_CODE_SIZE);
+		resolved.copy(code, CC_CODE_SIZE - 1);
+		return CC_OK;
+	});
+}
+
+cc_status cc_get_stats(cc_converter* converter, cc_stats* stats)
+{
+	last_error = "";
+	if (converter == nullptr || stats == nullptr)
+	{
+		return fail(CC_ERROR_INVALID_ARGUMENT, "Arguments must not be NULL");
+	}
+
+	CurrencyConverter::AppState& app_state = converter->app_state;
+
+	*stats = {};
+	stats->currency_count = (uint32_t)app_state.currencies.size();
+	for (auto& element : app_state.currencies)
+	{
+		if (!element.second.exchange_rates.empty())
+		{
+			stats->cached_rate_count++;
+		}
+	}
+	stats->api_key_count = (uint32_t)app_state.api_keys.keys.size();
+	stats->active_api_key_count = (uint32_t)app_state.api_keys.active_count();
+	stats->remaining_quota = app_state.api_keys.remaining_quota();
+	stats->conversion_count = converter->conversion_count;
+	stats->failed_conversion_count = converter->failed_conversion_count;
+	stats->refresh_count = converter->refresh_count;
+	return CC_OK;
+}
+
+cc_status cc_get_audit_stats(cc_converter* converter, cc_audit_stats* stats)
+{
+	last_error = "";
+	if (converter == nullptr || stats == nullptr)
+	{
+		return fail(CC_ERROR_INVALID_ARGUMENT, "Arguments must not be NULL");
+	}
+
+	*stats = {};
+	if (converter->audit_log != nullptr)
+	{
+		stats->written_count = converter->audit_log->written_count();
+		stats->lost_count = converter->audit_log->lost_count();
+		stats->file_count = converter->audit_log->file_count();
+	}
+	return CC_OK;
+}
+
+cc_status cc_get_rate_statistics(cc_converter* converter, const char* source_code, const char* target_code, int64_t window_seconds, cc_rate_statistics* statistics)
+{
+	last_error = "";
+	if (converter == nullptr || source_code == nullptr || target_code == nullptr || statistics == nullptr)
+	{
+		return fail(CC_ERROR_INVALID_ARGUMENT, "Arguments must not be NULL");
+	}
+
+	return guarded(converter, [&]() {
+		CurrencyConverter::AppState& app_state = converter->app_state;
+		auto source = app_state.currencies.find(source_code);
+		if (source == app_state.currencies.end())
+		{
+			return fail(CC_ERROR_UNKNOWN_CURRENCY, "Unknown source currency");
+		}
+		cc_status fetched = fetch_source_rates(app_state, source->second);
+		if (fetched != CC_OK)
+		{
+			return fetched;
+		}
+		if (!source->second.exchange_rates.contains(target_code))
+		{
+			return fail(CC_ERROR_UNKNOWN_CURRENCY, "Unknown target currency");
+		}
+
+		CurrencyConverter::RateStatistics found {};
+		cc_status status = get_pair_statistics(app_state, source_code, target_code, window_seconds, found);
+		if (status != CC_OK)
+		{
+			return status;
+		}
+		statistics->spot = found.spot;
+		statistics->twap = found.twap;
+		statistics->min = found.min;
+		statistics->max = found.max;
+		statistics->volatility = found.volatility;
+		statistics->samples = found.samples;
+		statistics->covered_seconds = found.covered_seconds;
+		return CC_OK;
+	});
+}
+
+cc_status cc_open_audit_log(cc_converter* converter, const char* directory)
+{
+	last_error = "";
+	if (converter == nullptr || directory == nullptr)
+	{
+		return fail(CC_ERROR_INVALID_ARGUMENT, "Arguments must not be NULL");
+	}
+	if (converter->audit_log != nullptr)
+	{
+		return fail(CC_ERROR_INVALID_ARGUMENT, "Audit log is already open");
+	}
+
+	CurrencyConverter::AuditLogOptions options = CurrencyConverter::AuditLogOptions();
+	options.directory = directory;
+	std::unique_ptr<CurrencyConverter::AuditLog> audit_log = std::make_unique<CurrencyConverter::AuditLog>();
+	if (!audit_log->open(options))
+	{
+		return fail(CC_ERROR_IO, "Could not create the audit log");
+	}
+	converter->audit_log = std::move(audit_log);
+	converter->app_state.audit_log = converter->audit_log.get();
+	return CC_OK;
+}
+
+void cc_destroy(cc_converter* converter)
+{
+	delete converter;
+}
+
+const char* cc_last_error(void)
+{
+	return last_error.c_str();
+}
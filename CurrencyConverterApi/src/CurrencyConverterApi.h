@@ -0,0 +1,172 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// C interface of CurrencyConverterApi.dll so that programs in other languages can convert in-process.
+// Only plain C types cross the boundary. Exceptions never leave the dll.
+//
+// Usage:
+//     cc_converter* converter = NULL;
+//     if (cc_init("key1,key2", NULL, "EUR", &converter) != CC_OK) {
+//         puts(cc_last_error());
+//     }
+//     double result;
+//     cc_convert(converter, "EUR", "USD", 100.0, &result);
+//     cc_destroy(converter);
+//
+// A converter is not thread safe. Use one per thread or serialize the calls.
+// cc_init, cc_refresh and conversions with a source currency that has no cached rates yet make blocking http requests.
+// Problems are written to stderr the same way the interactive program does it.
+//
+// Compatibility: functions and fields only ever get added. New fields go to the end of the structs.
+// cc_stats is frozen since callers keep it on their stack. New counters get their own struct, like cc_audit_stats.
+// CC_ABI_VERSION changes whenever that happens.
+
+#if defined(CURRENCYCONVERTER_API_EXPORTS)
+#define CC_API __declspec(dllexport)
+#else
+#define CC_API __declspec(dllimport)
+#endif
+
+#define CC_ABI_VERSION 7
+
+// Bytes of a currency code including the terminating zero, e.g. "EUR", "USDT" or "MATIC".
+// Codes that don't fit are never cut off, they fail with CC_ERROR_UNKNOWN_CURRENCY instead.
+#define CC_CODE_SIZE 8
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum cc_status {
+	CC_OK = 0,
+	// NULL pointer, NaN amount, ...
+	CC_ERROR_INVALID_ARGUMENT = 1,
+	// Currency code isn't in the currency list of the api
+	CC_ERROR_UNKNOWN_CURRENCY = 2,
+	// A request failed or got an error response. Details in cc_last_error().
+	CC_ERROR_REQUEST_FAILED = 3,
+	// No api key left that isn't invalid or rate limited
+	CC_ERROR_NO_API_KEY = 4,
+	CC_ERROR_INTERNAL = 5,
+	// A file couldn't be created, e.g. the audit log
+	CC_ERROR_IO = 6,
+	// The converter hasn't seen any rates of the pair in the window yet
+	CC_ERROR_NO_AVERAGE_RATE = 7
+} cc_status;
+
+// Opaque handle owning the currency list, the cached rates and the api keys
+typedef struct cc_converter cc_converter;
+
+// One row of cc_convert_batch(). Codes are zero terminated.
+typedef struct cc_conversion {
+	char source_code[CC_CODE_SIZE];
+	char target_code[CC_CODE_SIZE];
+	double amount;
+	// Written by cc_convert_batch()
+	double result;
+	int32_t status;
+} cc_conversion;
+
+// One result of cc_search_currencies()
+typedef struct cc_search_result {
+	char code[CC_CODE_SIZE];
+	// Higher is better
+	int32_t score;
+} cc_search_result;
+
+// Statistics of one pair over one window, see cc_get_rate_statistics()
+typedef struct cc_rate_statistics {
+	// Latest rate
+	double spot;
+	// Time weighted average rate of the window
+	double twap;
+	double min;
+	double max;
+	// Standard deviation of the log returns between updates in the window
+	double volatility;
+	// Rate updates that were in effect during the window
+	uint64_t samples;
+	// Part of the window there are rates for. Shorter than the window while the converter is young.
+	int64_t covered_seconds;
+} cc_rate_statistics;
+
+typedef struct cc_stats {
+	uint32_t currency_count;
+	// Currencies whose exchange rates are cached
+	uint32_t cached_rate_count;
+	uint32_t api_key_count;
+	uint32_t active_api_key_count;
+	// Sum over all active keys
+	uint64_t remaining_quota;
+	uint64_t conversion_count;
+	uint64_t failed_conversion_count;
+	uint64_t refresh_count;
+} cc_stats;
+
+// See cc_get_audit_stats()
+typedef struct cc_audit_stats {
+	// Conversions that made it into the audit log files
+	uint64_t written_count;
+	// Conversions that didn't, because the buffer was full or a file couldn't be written
+	uint64_t lost_count;
+	uint64_t file_count;
+} cc_audit_stats;
+
+// Version of this header the dll got built with
+CC_API uint32_t cc_abi_version(void);
+
+// Checks the api keys and loads the currency list.
+// api_keys: comma separated list of keys.
+// api_url: NULL for https://api.freecurrencyapi.com/v1.
+// prefetch_bases: comma separated currency codes whose rates get fetched right away, or NULL.
+// On failure *converter stays NULL.
+CC_API cc_status cc_init(const char* api_keys, const char* api_url, const char* prefetch_bases, cc_converter** converter);
+
+// Conditionally refetches the currency list and the rates of every currency with cached rates
+CC_API cc_status cc_refresh(cc_converter* converter);
+
+// Fetches the rates of source_code first if they aren't cached
+CC_API cc_status cc_convert(cc_converter* converter, const char* source_code, const char* target_code, double amount, double* result);
+
+// Like cc_convert() but with the time weighted average rate of the last window_seconds instead of the latest rate,
+// e.g. 86400 to settle at the 24h TWAP. Windows are 3600, 86400 and 2592000 seconds.
+// Averages only cover the rates this converter has seen since cc_init().
+// CC_ERROR_INVALID_ARGUMENT for any other window, CC_ERROR_NO_AVERAGE_RATE if there is no average yet.
+CC_API cc_status cc_convert_at_twap(cc_converter* converter, const char* source_code, const char* target_code, double amount, int64_t window_seconds, double* result);
+
+// Converts every row and writes result and status into it.
+// Returns CC_OK if every row succeeded, otherwise the status of the first failed row.
+CC_API cc_status cc_convert_batch(cc_converter* converter, cc_conversion* conversions, size_t count);
+
+// Finds currencies by code, name, plural name or symbol, e.g. "swiss fr", "yen" or "$". Misspelled names are found too.
+// Writes up to capacity results, best first, and their number into *count. Currencies whose code doesn't fit are left out.
+CC_API cc_status cc_search_currencies(cc_converter* converter, const char* query, cc_search_result* results, size_t capacity, size_t* count);
+
+// Writes the code of the one currency the query clearly identifies into code.
+// CC_ERROR_UNKNOWN_CURRENCY if nothing matches, several currencies match equally well or the code doesn't fit.
+CC_API cc_status cc_resolve_currency(cc_converter* converter, const char* query, char code[CC_CODE_SIZE]);
+
+// Records every following conversion of this converter (pair, amount, rate, rate timestamp, result, window of an average rate)
+// in rotating binary files in directory. Costs a few tens of nanoseconds per conversion.
+// The files get written by a background thread and can be read with "CurrencyConverter.exe --audit-decode=<directory>".
+CC_API cc_status cc_open_audit_log(cc_converter* converter, const char* directory);
+
+// Latest rate of source_code -> target_code with its time weighted average, min, max and volatility over the last window_seconds.
+// Fetches the rates of source_code first if they aren't cached. Fails like cc_convert_at_twap() without statistics.
+CC_API cc_status cc_get_rate_statistics(cc_converter* converter, const char* source_code, const char* target_code, int64_t window_seconds, cc_rate_statistics* statistics);
+
+CC_API cc_status cc_get_stats(cc_converter* converter, cc_stats* stats);
+
+// All zero if the audit log isn't open
+CC_API cc_status cc_get_audit_stats(cc_converter* converter, cc_audit_stats* stats);
+
+// Accepts NULL
+CC_API void cc_destroy(cc_converter* converter);
+
+// Message of the last failed call on this thread. Empty string if there is none. Valid until the next call on this thread.
+CC_API const char* cc_last_error(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,227 @@
+#include "AllocationTracker.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <iomanip>
+#include <malloc.h>
+
+namespace CurrencyConverter
+{
+	constexpr size_t TAG_COUNT = (size_t)AllocationTag::Count;
+
+	// Global totals per tag. Plain atomics so that counting never allocates itself.
+	static std::atomic<uint64_t> tag_allocations[TAG_COUNT];
+	static std::atomic<uint64_t> tag_bytes[TAG_COUNT];
+
+	// Per thread state. Trivial types only, so thread_local doesn't need any dynamic initialization.
+	static thread_local AllocationTag current_tag = AllocationTag::Untagged;
+	static thread_local uint64_t thread_allocations = 0;
+	static thread_local uint64_t thread_bytes = 0;
+
+	const char* allocation_tag_name(AllocationTag tag)
+	{
+		switch (tag)
+		{
+			case AllocationTag::Untagged:
+				return "untagged";
+			case AllocationTag::Startup:
+				return "startup";
+			case AllocationTag::Fetch:
+				return "fetch";
+			case AllocationTag::Parse:
+				return "parse";
+			case AllocationTag::Convert:
+				return "convert";
+			case AllocationTag::Render:
+				return "render";
+			default:
+				return "unknown";
+		}
+	}
+
+	bool allocation_tracking_enabled()
+	{
+#ifdef CURRENCYCONVERTER_TRACK_ALLOCATIONS
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	AllocationCounters get_allocation_counters(AllocationTag tag)
+	{
+		AllocationCounters counters {};
+		size_t index = (size_t)tag;
+		if (index < TAG_COUNT)
+		{
+			counters.allocations = tag_allocations[index].load(std::memory_order_relaxed);
+			counters.bytes = tag_bytes[index].load(std::memory_order_relaxed);
+		}
+		return counters;
+	}
+
+	void reset_allocation_counters()
+	{
+		for (size_t i = 0; i < TAG_COUNT; i++)
+		{
+			tag_allocations[i].store(0, std::memory_order_relaxed);
+			tag_bytes[i].store(0, std::memory_order_relaxed);
+		}
+	}
+
+	void write_allocation_summary(std::ostream& stream)
+	{
+		if (!allocation_tracking_enabled())
+		{
+			stream << "Allocation tracking isn't enabled in this build." << '\n';
+			return;
+		}
+
+		stream << "---------- Heap allocations per operation ----------" << '\n';
+		stream << std::left << std::setw(12) << "operation" << std::right << std::setw(14) << "allocations" << std::setw(16) << "bytes" << '\n';
+		for (size_t i = 0; i < TAG_COUNT; i++)
+		{
+			AllocationCounters counters = get_allocation_counters((AllocationTag)i);
+			stream << std::left << std::setw(12) << allocation_tag_name((AllocationTag)i)
+				<< std::right << std::setw(14) << counters.allocations
+				<< std::setw(16) << counters.bytes << '\n';
+		}
+		stream << std::left;
+	}
+
+#ifdef CURRENCYCONVERTER_TRACK_ALLOCATIONS
+	AllocationScope::AllocationScope(AllocationTag tag)
+	{
+		this->previous = current_tag;
+		current_tag = tag;
+	}
+
+	AllocationScope::~AllocationScope()
+	{
+		current_tag = this->previous;
+	}
+
+	// Called by the replaced operator new for every allocation
+	static void count_allocation(size_t size)
+	{
+		size_t index = (size_t)current_tag;
+		tag_allocations[index].fetch_add(1, std::memory_order_relaxed);
+		tag_bytes[index].fetch_add(size, std::memory_order_relaxed);
+		thread_allocations++;
+		thread_bytes += size;
+	}
+#endif
+
+	AllocationBudget::AllocationBudget()
+	{
+		this->start.allocations = thread_allocations;
+		this->start.bytes = thread_bytes;
+	}
+
+	AllocationBudget::~AllocationBudget()
+	{
+	}
+
+	uint64_t AllocationBudget::allocations()
+	{
+		return thread_allocations - this->start.allocations;
+	}
+
+	uint64_t AllocationBudget::bytes()
+	{
+		return thread_bytes - this->start.bytes;
+	}
+
+	bool AllocationBudget::within(uint64_t max_allocations, uint64_t max_bytes)
+	{
+		return this->allocations() <= max_allocations && this->bytes() <= max_bytes;
+	}
+}
+
+#ifdef CURRENCYCONVERTER_TRACK_ALLOCATIONS
+// ---------- Replaced global allocation functions ----------
+// Only the allocating side is counted. The deallocating side just has to match the allocation function used.
+
+void* operator new(size_t size)
+{
+	CurrencyConverter::count_allocation(size);
+	void* memory = malloc(size == 0 ? 1 : size);
+	if (memory == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	CurrencyConverter::count_allocation(size);
+	return malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept
+{
+	return operator new(size, tag);
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+	CurrencyConverter::count_allocation(size);
+	void* memory = _aligned_malloc(size == 0 ? 1 : size, (size_t)alignment);
+	if (memory == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+	return operator new(size, alignment);
+}
+
+void operator delete(void* memory) noexcept
+{
+	free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+	free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+	_aligned_free(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept
+{
+	_aligned_free(memory);
+}
+
+void operator delete(void* memory, size_t, std::align_val_t) noexcept
+{
+	_aligned_free(memory);
+}
+
+void operator delete[](void* memory, size_t, std::align_val_t) noexcept
+{
+	_aligned_free(memory);
+}
+#endif
@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+#include <ostream>
+
+// Allocation tracking is opt-in. It is only compiled in when CURRENCYCONVERTER_TRACK_ALLOCATIONS is defined,
+// which the "Instrumented" configuration of the project does.
+// In every other build AllocationScope compiles to nothing and the global operator new stays untouched.
+
+namespace CurrencyConverter
+{
+	// Operations heap allocations get attributed to
+	enum class AllocationTag : uint8_t {
+		Untagged,
+		Startup,
+		Fetch,
+		Parse,
+		Convert,
+		Render,
+		Count
+	};
+
+	struct AllocationCounters {
+		uint64_t allocations;
+		uint64_t bytes;
+	};
+
+	const char* allocation_tag_name(AllocationTag tag);
+
+	// True if this build counts allocations
+	bool allocation_tracking_enabled();
+
+	// Totals of all threads for one tag
+	AllocationCounters get_allocation_counters(AllocationTag tag);
+	void reset_allocation_counters();
+
+	// Writes a table of all tags with their allocation counts and bytes
+	void write_allocation_summary(std::ostream& stream);
+
+#ifdef CURRENCYCONVERTER_TRACK_ALLOCATIONS
+	// Attributes every allocation the current thread makes while the scope is alive to the given tag.
+	// Scopes can be nested. The innermost scope wins and the previous tag is restored on destruction.
+	class AllocationScope {
+	public:
+		explicit AllocationScope(AllocationTag tag);
+		~AllocationScope();
+
+		AllocationScope(const AllocationScope&) = delete;
+		AllocationScope& operator=(const AllocationScope&) = delete;
+
+	private:
+		AllocationTag previous;
+	};
+#else
+	class AllocationScope {
+	public:
+		explicit AllocationScope(AllocationTag) {}
+	};
+#endif
+
+	// Counts the allocations the current thread makes between construction and the query.
+	// Meant for budgets like "a conversion with warm rates performs zero allocations":
+	//
+	//     AllocationBudget budget;
+	//     convert_money(app_state, "EUR", "USD", 100.0f);
+	//     assert(budget.within(0));
+	//
+	// Always reports 0 allocations when tracking isn't compiled in.
+	class AllocationBudget {
+	public:
+		AllocationBudget();
+		~AllocationBudget();
+
+		uint64_t allocations();
+		uint64_t bytes();
+		bool within(uint64_t max_allocations, uint64_t max_bytes = UINT64_MAX);
+
+	private:
+		AllocationCounters start;
+	};
+}
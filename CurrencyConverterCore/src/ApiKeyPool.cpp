@@ -0,0 +1,165 @@
+#include "ApiKeyPool.h"
+#include <format>
+#include <sstream>
+
+namespace CurrencyConverter
+{
+	ApiKey::ApiKey()
+	{
+		this->key = "";
+		this->account = Account();
+		this->state = ApiKeyState::Active;
+		this->last_used = 0;
+	}
+
+	ApiKey::ApiKey(string key)
+	{
+		this->key = key;
+		this->account = Account();
+		this->state = ApiKeyState::Active;
+		this->last_used = 0;
+	}
+
+	ApiKey::~ApiKey()
+	{
+	}
+
+	const char* ApiKey::state_name()
+	{
+		switch (this->state)
+		{
+			case ApiKeyState::Active:
+				return "active";
+			case ApiKeyState::RateLimited:
+				return "rate limited";
+			case ApiKeyState::Invalid:
+				return "invalid";
+			default:
+				return "unknown";
+		}
+	}
+
+	void ApiKey::count_request()
+	{
+		this->account.quotas.used += 1;
+		if (this->account.quotas.remaining > 0)
+		{
+			this->account.quotas.remaining -= 1;
+		}
+	}
+
+	string ApiKey::to_string()
+	{
+		// Only the end of the key is shown so that it doesn't end up in screenshots
+		string shown_key = this->key.size() > 4 ? "..." + this->key.substr(this->key.size() - 4) : this->key;
+		return std::format("Api key {} ({})\n{}", shown_key, this->state_name(), this->account.to_string());
+	}
+
+	ApiKeyPool::ApiKeyPool()
+	{
+		this->use_counter = 0;
+	}
+
+	ApiKeyPool::~ApiKeyPool()
+	{
+	}
+
+	void ApiKeyPool::add(const string& key)
+	{
+		this->keys.push_back(ApiKey(key));
+	}
+
+	void ApiKeyPool::add_all(const string& keys)
+	{
+		std::stringstream list(keys);
+		string key = "";
+		while (getline(list, key, ','))
+		{
+			if (!key.empty())
+			{
+				this->add(key);
+			}
+		}
+	}
+
+	bool ApiKeyPool::empty()
+	{
+		return this->keys.empty();
+	}
+
+	ApiKey* ApiKeyPool::acquire()
+	{
+		ApiKey* best = nullptr;
+		for (auto& candidate : this->keys)
+		{
+			if (candidate.state != ApiKeyState::Active)
+			{
+				continue;
+			}
+			if (best == nullptr
+				|| candidate.account.quotas.remaining > best->account.quotas.remaining
+				|| (candidate.account.quotas.remaining == best->account.quotas.remaining && candidate.last_used < best->last_used))
+			{
+				best = &candidate;
+			}
+		}
+
+		if (best != nullptr)
+		{
+			this->use_counter++;
+			best->last_used = this->use_counter;
+		}
+		return best;
+	}
+
+	bool ApiKeyPool::fail_over(ApiKey& key, long response_code)
+	{
+		switch (response_code)
+		{
+			case 401:
+				key.state = ApiKeyState::Invalid;
+				break;
+			case 429:
+				key.state = ApiKeyState::RateLimited;
+				key.account.quotas.remaining = 0;
+				break;
+			default:
+				return false;
+		}
+
+		for (auto& candidate : this->keys)
+		{
+			if (candidate.state == ApiKeyState::Active)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	uint64_t ApiKeyPool::remaining_quota()
+	{
+		uint64_t remaining = 0;
+		for (auto& candidate : this->keys)
+		{
+			if (candidate.state == ApiKeyState::Active)
+			{
+				remaining += candidate.account.quotas.remaining;
+			}
+		}
+		return remaining;
+	}
+
+	size_t ApiKeyPool::active_count()
+	{
+		size_t count = 0;
+		for (auto& candidate : this->keys)
+		{
+			if (candidate.state == ApiKeyState::Active)
+			{
+				count++;
+			}
+		}
+		return count;
+	}
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "Account.h"
+
+namespace CurrencyConverter
+{
+	using std::string;
+
+	enum class ApiKeyState {
+		Active,
+		// Got a 429. Out of rotation until the program restarts.
+		RateLimited,
+		// Got a 401
+		Invalid
+	};
+
+	// One api key together with the account data the status endpoint reported for it
+	class ApiKey {
+	public:
+		ApiKey();
+		ApiKey(string key);
+		~ApiKey();
+
+		string to_string();
+		const char* state_name();
+		// Books a successful request on the quotas of this key
+		void count_request();
+
+		string key;
+		Account account;
+		ApiKeyState state;
+		// Position of the last request made with this key. Spreads requests evenly while quotas are equal.
+		uint64_t last_used;
+	};
+
+	// All api keys passed on the command line.
+	// Each request takes the active key with the most remaining quota.
+	// Keys that get rejected are taken out of rotation so that the request can be repeated with another key.
+	class ApiKeyPool {
+	public:
+		ApiKeyPool();
+		~ApiKeyPool();
+
+		// Keys must all be added before the first acquire() since acquire() hands out pointers into keys.
+		void add(const string& key);
+		// Adds every key of a comma separated list like "key1,key2,key3". Empty entries are skipped.
+		void add_all(const string& keys);
+		bool empty();
+
+		// Active key with the most remaining quota. nullptr if every key is rate limited or invalid.
+		ApiKey* acquire();
+
+		// Takes the key out of rotation after a 401 or 429 response.
+		// Returns true if another active key is left to repeat the request with.
+		bool fail_over(ApiKey& key, long response_code);
+
+		// Sum of the remaining quotas of all active keys
+		uint64_t remaining_quota();
+		size_t active_count();
+
+		std::vector<ApiKey> keys;
+
+	private:
+		uint64_t use_counter;
+	};
+}
@@ -0,0 +1,32 @@
+#include "AppState.h"
+
+namespace CurrencyConverter
+{
+	AppState::AppState()
+	{
+		this->api_url = "https://api.freecurrencyapi.com/v1";
+		this->rates_update_interval = 24 * 60 * 60;
+		this->trace_recorder = nullptr;
+		this->response_replay = nullptr;
+		this->replayed_time = 0;
+		this->currency_list_version = 0;
+		this->audit_log = nullptr;
+
+		this->rate_table.subscribe([this](const string& base_code, const std::map<string, float>& exchange_rates, int64_t last_updated_at) {
+			this->rate_analytics.update(base_code, exchange_rates, last_updated_at);
+		});
+	}
+
+	AppState::~AppState()
+	{
+	}
+
+	int64_t AppState::now()
+	{
+		if (this->replayed_time != 0)
+		{
+			return this->replayed_time;
+		}
+		return (int64_t)time(nullptr);
+	}
+}
\ No newline at end of file
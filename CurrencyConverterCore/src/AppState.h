@@ -0,0 +1,73 @@
+#pragma once
+#include <string>
+#include <ctime>
+
+#include "Currency.h"
+#include "Account.h"
+#include "ApiKeyPool.h"
+#include "RateTable.h"
+#include "RateAnalytics.h"
+#include "FetchValidators.h"
+#include "CurrencySearch.h"
+#include "SessionTrace.h"
+#include "AuditLog.h"
+
+namespace CurrencyConverter
+{
+	using std::string;
+
+	class AppState {
+	public:
+		AppState();
+		~AppState();
+
+		// Unix time in seconds. Everything time dependent (cache age, average rates) asks this instead of the system clock.
+		int64_t now();
+
+		// Used for API access, parse from command line arguments.
+		// Every key has its own account data.
+		ApiKeyPool api_keys;
+
+		// Base url of the api. Can be pointed to a local stand-in server with --api-url.
+		string api_url;
+
+		// Map was choosen over unordered_map because I want the currencies to be ordered alphabetically
+		// and any map in this program will never have more than 32 entries.
+		// That means the difference in time complexity (O(log n) vs O(1)) isn't a significant difference for this program.
+		// Even if I switch to Currencyapi.com as a data source these maps won't have more than 172 entries.
+
+		// Map storing available currencies (key: currency->code, Currency instance).
+		std::map<string, Currency> currencies;
+		// Changes whenever the currency list gains a currency, see Currency::rates_currency_list_version
+		uint64_t currency_list_version;
+
+		// Finds currencies by name, plural name or symbol as well. Rebuilt whenever the currency list changes.
+		CurrencySearch currency_search;
+
+		// Copy of all fetched exchange rates in a fixed layout that can be read without locks.
+		// Gets moved into shared memory in publisher mode so that other processes can read it.
+		RateTable rate_table;
+
+		// Time weighted averages, min, max and volatility of every pair over the last hour, day and 30 days.
+		// Fed with every row the rate table publishes.
+		RateAnalytics rate_analytics;
+
+		// Validators of the last responses per endpoint (key: CURRENCIES_VALIDATORS_KEY or EXCHANGE_RATES_VALIDATORS_KEY + base code).
+		std::map<string, FetchValidators> fetch_validators;
+
+		// Upstream publishes new exchange rates once a day. Cached rates younger than this don't get requested again.
+		int64_t rates_update_interval;
+
+		// Set with --record. Commands and api responses of this session get written to a trace file.
+		TraceRecorder* trace_recorder;
+
+		// Set for replayed sessions. Requests get answered from the trace instead of the api.
+		ResponseReplay* response_replay;
+		// Set for replayed sessions to the recorded unix time of the command, so that cache ages and averages
+		// come out the same in every replay. 0 uses the system clock.
+		int64_t replayed_time;
+
+		// Set with --audit. Every conversion gets recorded in it.
+		AuditLog* audit_log;
+	};
+}
@@ -0,0 +1,132 @@
+#include "AsyncFetch.h"
+#include "AllocationTracker.h"
+#include <curlpp/Options.hpp>
+#include <curlpp/Infos.hpp>
+#include <windows.h>
+
+// select() lives in winsock
+#pragma comment(lib, "Ws2_32.lib")
+
+using namespace curlpp::options;
+
+namespace CurrencyConverter
+{
+	AsyncFetcher::AsyncFetcher()
+	{
+	}
+
+	AsyncFetcher::~AsyncFetcher()
+	{
+		// Handles have to leave the multi handle before they get destroyed
+		for (auto& pending_request : this->pending)
+		{
+			this->multi.remove(&pending_request->request);
+		}
+	}
+
+	std::future<FetchResponse> AsyncFetcher::fetch(const string& url, const std::list<string>& headers)
+	{
+		AllocationScope allocation_scope(AllocationTag::Fetch);
+
+		auto pending_request = std::make_unique<PendingRequest>();
+
+		pending_request->request.setOpt(new Url(url));
+		pending_request->request.setOpt(new HttpHeader(headers));
+		pending_request->request.setOpt(new WriteStream(&pending_request->response_body));
+
+		// Collect the response headers for validators like ETag
+		PendingRequest* target = pending_request.get();
+		pending_request->request.setOpt(new HeaderFunction([target](char* data, size_t size, size_t count) {
+			target->response_headers.append(data, size * count);
+			return size * count;
+		}));
+
+		std::future<FetchResponse> result = pending_request->promise.get_future();
+		this->multi.add(&pending_request->request);
+		this->pending.push_back(std::move(pending_request));
+		return result;
+	}
+
+	void AsyncFetcher::run()
+	{
+		AllocationScope allocation_scope(AllocationTag::Fetch);
+
+		int running_handles = 0;
+
+		// perform() returns false as long as curl wants to be called again right away
+		while (!this->multi.perform(&running_handles)) {}
+		this->collect_finished();
+
+		while (running_handles > 0)
+		{
+			fd_set read_set;
+			fd_set write_set;
+			fd_set exception_set;
+			FD_ZERO(&read_set);
+			FD_ZERO(&write_set);
+			FD_ZERO(&exception_set);
+			int max_fd = -1;
+
+			this->multi.fdset(&read_set, &write_set, &exception_set, &max_fd);
+
+			if (max_fd == -1)
+			{
+				// Curl has nothing to wait on yet (e.g. while resolving names). The curl docs recommend a short sleep here.
+				Sleep(100);
+			}
+			else
+			{
+				// Wait until one of the sockets is ready but wake up regularly so that curl can handle its timeouts
+				timeval timeout {};
+				timeout.tv_sec = 0;
+				timeout.tv_usec = 100 * 1000;
+				select(max_fd + 1, &read_set, &write_set, &exception_set, &timeout);
+			}
+
+			while (!this->multi.perform(&running_handles)) {}
+			this->collect_finished();
+		}
+
+		this->collect_finished();
+	}
+
+	void AsyncFetcher::collect_finished()
+	{
+		curlpp::Multi::Msgs messages = this->multi.info();
+		for (auto& message : messages)
+		{
+			if (message.second.msg != CURLMSG_DONE)
+			{
+				continue;
+			}
+
+			for (auto iterator = this->pending.begin(); iterator != this->pending.end(); iterator++)
+			{
+				PendingRequest* pending_request = iterator->get();
+				if (&pending_request->request != message.first)
+				{
+					continue;
+				}
+
+				FetchResponse response {};
+				if (message.second.code == CURLE_OK)
+				{
+					response.response_code = curlpp::infos::ResponseCode::get(pending_request->request);
+					response.headers = pending_request->response_headers;
+					response.body = pending_request->response_body.str();
+				}
+				else
+				{
+					// Transfer failed. Response code 0 lets the callers treat it like any other unexpected response.
+					response.response_code = 0;
+					response.error = curl_easy_strerror(message.second.code);
+				}
+
+				this->multi.remove(&pending_request->request);
+				pending_request->promise.set_value(std::move(response));
+				this->pending.erase(iterator);
+				break;
+			}
+		}
+	}
+}
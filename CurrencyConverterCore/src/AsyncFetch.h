@@ -0,0 +1,66 @@
+#pragma once
+#include <string>
+#include <list>
+#include <memory>
+#include <future>
+#include <sstream>
+
+#include <curlpp/cURLpp.hpp>
+#include <curlpp/Easy.hpp>
+#include <curlpp/Multi.hpp>
+
+namespace CurrencyConverter
+{
+	using std::string;
+
+	// Result of a finished request.
+	// If the transfer itself failed (no connection, timeout, ...) response_code is 0 and error describes the problem.
+	struct FetchResponse {
+		long response_code;
+		// Raw response headers, one "Name: value" per line
+		string headers;
+		string body;
+		string error;
+	};
+
+	// Runs any number of http requests concurrently on the calling thread by using the curl multi interface.
+	// Requests only get added by fetch(). Nothing is sent before run() gets called.
+	//
+	//     AsyncFetcher fetcher;
+	//     auto status = fetcher.fetch(url_a, headers);
+	//     auto currencies = fetcher.fetch(url_b, headers);
+	//     fetcher.run();            // both requests are in flight at the same time
+	//     status.get().body ...
+	//
+	// That way the time needed for several independent requests is the time of the slowest one and not the sum of all.
+	class AsyncFetcher {
+	public:
+		AsyncFetcher();
+		~AsyncFetcher();
+
+		AsyncFetcher(const AsyncFetcher&) = delete;
+		AsyncFetcher& operator=(const AsyncFetcher&) = delete;
+
+		// Queues a GET request. The future becomes ready during run().
+		std::future<FetchResponse> fetch(const string& url, const std::list<string>& headers);
+
+		// Drives the event loop until every queued request has finished.
+		void run();
+
+	private:
+		struct PendingRequest {
+			curlpp::Easy request;
+			std::stringstream response_body;
+			string response_headers;
+			std::promise<FetchResponse> promise;
+		};
+
+		// Has to be the first member so that curl gets initialized before and cleaned up after the handles.
+		curlpp::Cleanup cleaner;
+		curlpp::Multi multi;
+		std::list<std::unique_ptr<PendingRequest>> pending;
+
+		// Fulfills the promises of all requests curl reports as done.
+		void collect_finished();
+	};
+}
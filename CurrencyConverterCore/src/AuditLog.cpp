@@ -0,0 +1,576 @@
+#include "AuditLog.h"
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <format>
+#include <filesystem>
+#include <sstream>
+#include <algorithm>
+#include <iostream>
+
+#include "BinaryEncoding.h"
+#include "RateAnalytics.h"
+
+namespace CurrencyConverter
+{
+	// Written records get collected into blocks of about this size before they go to the file
+	constexpr size_t AUDIT_WRITE_BLOCK = 64 * 1024;
+
+	// Logs a thread remembers its ring for. Threads rarely record to more than one or two.
+	constexpr size_t AUDIT_THREAD_RING_SLOTS = 8;
+
+	// Ring of the calling thread for the log with that id
+	struct ThreadAuditRing {
+		uint64_t log_id;
+		AuditRing* ring;
+	};
+	struct ThreadAuditRings {
+		ThreadAuditRing slots[AUDIT_THREAD_RING_SLOTS];
+		// Slot that gets replaced next
+		size_t next;
+	};
+	static thread_local ThreadAuditRings thread_audit_rings = {};
+	static std::atomic<uint64_t> next_audit_log_id = 1;
+
+	AuditLogOptions::AuditLogOptions()
+	{
+		this->directory = "audit";
+		this->max_file_bytes = 64 * 1024 * 1024;
+		this->flush_interval_milliseconds = 1;
+	}
+
+	AuditLog::AuditLog()
+	{
+		this->id = 0;
+		this->running = false;
+		this->file_bytes = 0;
+		this->file_prefix = "";
+		this->previous = AuditRecord();
+		this->buffer = "";
+		this->buffered_records = 0;
+		this->failed = false;
+		this->written = 0;
+		this->lost = 0;
+		this->files = 0;
+	}
+
+	AuditLog::~AuditLog()
+	{
+		this->close();
+	}
+
+	bool AuditLog::open(const AuditLogOptions& options)
+	{
+		if (this->is_open())
+		{
+			return false;
+		}
+		this->options = options;
+
+		std::error_code error;
+		std::filesystem::create_directories(options.directory, error);
+
+		// Files of one run share the utc time the log was opened, so their names sort in the order they were written
+		time_t now = time(nullptr);
+		std::tm utc {};
+		gmtime_s(&utc, &now);
+		this->file_prefix = std::format("audit-{:04}{:02}{:02}-{:02}{:02}{:02}", utc.tm_year + 1900, utc.tm_mon + 1, utc.tm_mday, utc.tm_hour, utc.tm_min, utc.tm_sec);
+		this->files = 0;
+		this->buffered_records = 0;
+		this->failed = false;
+		if (!this->open_next_file())
+		{
+			return false;
+		}
+
+		// A new id makes threads register a new ring, even if this log was open before
+		this->id = next_audit_log_id.fetch_add(1);
+		this->written = 0;
+		this->lost = 0;
+		this->running = true;
+		this->flusher = std::thread(&AuditLog::run_flusher, this);
+		return true;
+	}
+
+	void AuditLog::close()
+	{
+		if (!this->is_open())
+		{
+			return;
+		}
+		this->running.store(false, std::memory_order_release);
+		this->flusher.join();
+
+		std::lock_guard<std::mutex> lock(this->rings_mutex);
+		this->rings.clear();
+	}
+
+	bool AuditLog::is_open()
+	{
+		return this->flusher.joinable();
+	}
+
+	uint64_t AuditLog::written_count()
+	{
+		return this->written.load(std::memory_order_relaxed);
+	}
+
+	uint64_t AuditLog::lost_count()
+	{
+		return this->lost.load(std::memory_order_relaxed);
+	}
+
+	uint64_t AuditLog::file_count()
+	{
+		return this->files.load(std::memory_order_relaxed);
+	}
+
+	// Slow path of record(), once per thread unless it records to more logs than it has slots
+	AuditRing* AuditLog::register_thread()
+	{
+		std::thread::id thread = std::this_thread::get_id();
+		AuditRing* ring = nullptr;
+		{
+			std::lock_guard<std::mutex> lock(this->rings_mutex);
+			// The thread may have had a ring before its slot got taken by another log
+			for (auto& existing : this->rings)
+			{
+				if (existing->owner == thread)
+				{
+					ring = existing.get();
+					break;
+				}
+			}
+			if (ring == nullptr)
+			{
+				std::unique_ptr<AuditRing> added = std::make_unique<AuditRing>();
+				added->owner = thread;
+				added->head = 0;
+				added->cached_tail = 0;
+				added->tail = 0;
+				added->dropped = 0;
+				ring = added.get();
+				this->rings.push_back(std::move(added));
+			}
+		}
+
+		ThreadAuditRing& slot = thread_audit_rings.slots[thread_audit_rings.next];
+		thread_audit_rings.next = (thread_audit_rings.next + 1) % AUDIT_THREAD_RING_SLOTS;
+		slot.log_id = this->id;
+		slot.ring = ring;
+		return ring;
+	}
+
+	void AuditLog::record(const string& source, const string& target, double amount, double rate, int64_t rate_updated_at, double result, int64_t rate_window_seconds)
+	{
+		// Ids are never reused, so a slot of a closed log never matches
+		AuditRing* ring = nullptr;
+		for (ThreadAuditRing& slot : thread_audit_rings.slots)
+		{
+			if (slot.log_id == this->id && slot.ring != nullptr)
+			{
+				ring = slot.ring;
+				break;
+			}
+		}
+		if (ring == nullptr)
+		{
+			ring = this->register_thread();
+		}
+
+		// Only the flusher moves the tail, so the one from last time is good enough until the ring looks full
+		uint64_t head = ring->head.load(std::memory_order_relaxed);
+		if (head - ring->cached_tail >= AUDIT_RING_CAPACITY)
+		{
+			ring->cached_tail = ring->tail.load(std::memory_order_acquire);
+			if (head - ring->cached_tail >= AUDIT_RING_CAPACITY)
+			{
+				// Never wait for the flusher. The loss gets written to the log instead.
+				ring->dropped.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+		}
+
+		AuditRecord& entry = ring->records[head % AUDIT_RING_CAPACITY];
+		entry.at = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+		entry.amount = amount;
+		entry.rate = rate;
+		entry.result = result;
+		entry.rate_updated_at = rate_updated_at;
+		entry.rate_window_seconds = rate_window_seconds;
+		memset(entry.source, 0, sizeof(entry.source));
+		memset(entry.target, 0, sizeof(entry.target));
+		memcpy(entry.source, source.data(), std::min(source.size(), sizeof(entry.source) - 1));
+		memcpy(entry.target, target.data(), std::min(target.size(), sizeof(entry.target) - 1));
+		entry.source_cut = source.size() >= sizeof(entry.source);
+		entry.target_cut = target.size() >= sizeof(entry.target);
+
+		// Publishes the record to the flusher
+		ring->head.store(head + 1, std::memory_order_release);
+	}
+
+	void AuditLog::run_flusher()
+	{
+		while (this->running.load(std::memory_order_acquire))
+		{
+			if (this->drain() == 0)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(this->options.flush_interval_milliseconds));
+			}
+		}
+		// Whatever got recorded before close()
+		this->drain();
+		this->file.close();
+	}
+
+	uint64_t AuditLog::drain()
+	{
+		{
+			std::lock_guard<std::mutex> lock(this->rings_mutex);
+			this->drained_rings.clear();
+			for (auto& ring : this->rings)
+			{
+				this->drained_rings.push_back(ring.get());
+			}
+		}
+
+		uint64_t drained = 0;
+		for (AuditRing* ring : this->drained_rings)
+		{
+			uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+			uint64_t head = ring->head.load(std::memory_order_acquire);
+			for (uint64_t position = tail; position < head; position++)
+			{
+				this->encode(ring->records[position % AUDIT_RING_CAPACITY]);
+			}
+			// Hands the slots back to the converting thread
+			ring->tail.store(head, std::memory_order_release);
+			drained += head - tail;
+
+			uint64_t dropped = ring->dropped.exchange(0, std::memory_order_relaxed);
+			if (dropped > 0)
+			{
+				this->encode_lost(dropped);
+			}
+		}
+		this->write_buffer();
+		return drained;
+	}
+
+	void AuditLog::encode(const AuditRecord& record)
+	{
+		if (!this->failed && this->file_bytes + this->buffer.size() >= this->options.max_file_bytes)
+		{
+			this->write_buffer();
+			if (!this->failed)
+			{
+				this->open_next_file();
+			}
+		}
+		if (this->failed)
+		{
+			this->lost.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		uint8_t flags = 0;
+		if (memcmp(record.source, this->previous.source, sizeof(record.source)) == 0 && memcmp(record.target, this->previous.target, sizeof(record.target)) == 0 && record.source_cut == this->previous.source_cut && record.target_cut == this->previous.target_cut)
+		{
+			flags |= AUDIT_SAME_PAIR;
+		}
+		else
+		{
+			flags |= (record.source_cut ? AUDIT_SOURCE_CUT : 0) | (record.target_cut ? AUDIT_TARGET_CUT : 0);
+		}
+		if (memcmp(&record.rate, &this->previous.rate, sizeof(double)) == 0 && record.rate_updated_at == this->previous.rate_updated_at
+			&& record.rate_window_seconds == this->previous.rate_window_seconds)
+		{
+			flags |= AUDIT_SAME_RATE;
+		}
+		else if (record.rate_window_seconds > 0)
+		{
+			flags |= AUDIT_AVERAGE_RATE;
+		}
+		// Always the case for convert_money(). The decoder does the same multiplication.
+		double product = record.amount * record.rate;
+		if (memcmp(&record.result, &product, sizeof(double)) == 0)
+		{
+			flags |= AUDIT_RESULT_IS_PRODUCT;
+		}
+
+		this->buffer.push_back((char)flags);
+		write_varint(this->buffer, zigzag_encode(record.at - this->previous.at));
+		if ((flags & AUDIT_SAME_PAIR) == 0)
+		{
+			write_bytes(this->buffer, std::string_view(record.source, strnlen(record.source, sizeof(record.source))));
+			write_bytes(this->buffer, std::string_view(record.target, strnlen(record.target, sizeof(record.target))));
+		}
+		if ((flags & AUDIT_SAME_RATE) == 0)
+		{
+			write_double(this->buffer, record.rate);
+			write_varint(this->buffer, zigzag_encode(record.rate_updated_at - this->previous.rate_updated_at));
+			if ((flags & AUDIT_AVERAGE_RATE) != 0)
+			{
+				write_varint(this->buffer, (uint64_t)record.rate_window_seconds);
+			}
+		}
+		write_double(this->buffer, record.amount);
+		if ((flags & AUDIT_RESULT_IS_PRODUCT) == 0)
+		{
+			write_double(this->buffer, record.result);
+		}
+		this->previous = record;
+		this->buffered_records++;
+
+		if (this->buffer.size() >= AUDIT_WRITE_BLOCK)
+		{
+			this->write_buffer();
+		}
+	}
+
+	void AuditLog::encode_lost(uint64_t count)
+	{
+		this->lost.fetch_add(count, std::memory_order_relaxed);
+		if (this->failed)
+		{
+			return;
+		}
+		int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+		this->buffer.push_back((char)AUDIT_LOST);
+		write_varint(this->buffer, zigzag_encode(now - this->previous.at));
+		write_varint(this->buffer, count);
+		this->previous.at = now;
+	}
+
+	void AuditLog::write_buffer()
+	{
+		if (this->buffer.empty())
+		{
+			return;
+		}
+		this->file.write(this->buffer.data(), (std::streamsize)this->buffer.size());
+		this->file.flush();
+		if (this->file)
+		{
+			this->written.fetch_add(this->buffered_records, std::memory_order_relaxed);
+		}
+		else
+		{
+			// E.g. the disk is full. Writing on would only lose records in the middle of a file.
+			std::cerr << "\n\tCould not write the audit log, further conversions are counted as lost\n";
+			this->lost.fetch_add(this->buffered_records, std::memory_order_relaxed);
+			this->failed = true;
+		}
+		this->file_bytes += this->buffer.size();
+		this->buffer.clear();
+		this->buffered_records = 0;
+	}
+
+	bool AuditLog::open_next_file()
+	{
+		this->file.close();
+		uint64_t number = this->files.fetch_add(1) + 1;
+		std::filesystem::path path = std::filesystem::path(this->options.directory) / std::format("{}-{:04}.ccal", this->file_prefix, number);
+		this->file.open(path, std::ios::binary | std::ios::trunc);
+		if (this->file)
+		{
+			this->file.write(AUDIT_MAGIC, (std::streamsize)strlen(AUDIT_MAGIC));
+			this->file.put((char)AUDIT_VERSION);
+		}
+		if (!this->file)
+		{
+			std::cerr << "\n\tCould not create audit log file " << path.string() << "\n";
+			this->failed = true;
+			return false;
+		}
+		this->file_bytes = strlen(AUDIT_MAGIC) + 1;
+		this->previous = AuditRecord();
+		return true;
+	}
+
+	// 2024-01-31T12:00:00Z, with nanoseconds if there are any
+	static string format_utc(int64_t seconds, int64_t nanoseconds)
+	{
+		time_t time = (time_t)seconds;
+		std::tm utc {};
+		gmtime_s(&utc, &time);
+		string text = std::format("{:04}-{:02}-{:02}T{:02}:{:02}:{:02}", utc.tm_year + 1900, utc.tm_mon + 1, utc.tm_mday, utc.tm_hour, utc.tm_min, utc.tm_sec);
+		if (nanoseconds != 0)
+		{
+			text += std::format(".{:09}", nanoseconds);
+		}
+		return text + "Z";
+	}
+
+	static string format_utc_nanoseconds(int64_t at)
+	{
+		// Rounds towards negative infinity so that the nanoseconds are never negative
+		int64_t seconds = at / 1000000000;
+		int64_t nanoseconds = at % 1000000000;
+		if (nanoseconds < 0)
+		{
+			seconds--;
+			nanoseconds += 1000000000;
+		}
+		return format_utc(seconds, nanoseconds);
+	}
+
+	static bool decode_audit_file(const string& path, std::ostream& stream, AuditFormat format)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file)
+		{
+			return false;
+		}
+		std::stringstream content;
+		content << file.rdbuf();
+		string data = content.str();
+
+		size_t magic_length = strlen(AUDIT_MAGIC);
+		if (data.size() < magic_length + 1 || data.compare(0, magic_length, AUDIT_MAGIC) != 0 || (uint8_t)data[magic_length] == 0 || (uint8_t)data[magic_length] > AUDIT_VERSION)
+		{
+			return false;
+		}
+
+		const char* position = data.data() + magic_length + 1;
+		const char* end = data.data() + data.size();
+		int64_t at = 0;
+		string source = "";
+		string target = "";
+		double rate = 0.0;
+		int64_t rate_updated_at = 0;
+		int64_t rate_window_seconds = 0;
+		while (position < end)
+		{
+			uint8_t flags = (uint8_t)*position;
+			position++;
+
+			// A record cut off at the end (e.g. after a crash) is ignored
+			uint64_t value = 0;
+			if (!read_varint(position, end, value))
+			{
+				break;
+			}
+			at += zigzag_decode(value);
+
+			if ((flags & AUDIT_LOST) != 0)
+			{
+				if (!read_varint(position, end, value))
+				{
+					break;
+				}
+				if (format == AuditFormat::Csv)
+				{
+					stream << "# " << value << " conversions lost at " << format_utc_nanoseconds(at) << '\n';
+				}
+				else
+				{
+					stream << format_utc_nanoseconds(at) << "  " << value << " conversions lost, the audit buffer was full" << '\n';
+				}
+				continue;
+			}
+
+			if ((flags & AUDIT_SAME_PAIR) == 0)
+			{
+				if (!(read_bytes(position, end, source) && read_bytes(position, end, target)))
+				{
+					break;
+				}
+				// "..." shows that the code went on, e.g. "TOOLONG..."
+				if ((flags & AUDIT_SOURCE_CUT) != 0)
+				{
+					source += "...";
+				}
+				if ((flags & AUDIT_TARGET_CUT) != 0)
+				{
+					target += "...";
+				}
+			}
+			if ((flags & AUDIT_SAME_RATE) == 0)
+			{
+				if (!read_double(position, end, rate) || !read_varint(position, end, value))
+				{
+					break;
+				}
+				rate_updated_at += zigzag_decode(value);
+				rate_window_seconds = 0;
+				if ((flags & AUDIT_AVERAGE_RATE) != 0)
+				{
+					if (!read_varint(position, end, value))
+					{
+						break;
+					}
+					rate_window_seconds = (int64_t)value;
+				}
+			}
+			double amount = 0.0;
+			if (!read_double(position, end, amount))
+			{
+				break;
+			}
+			double result = amount * rate;
+			if ((flags & AUDIT_RESULT_IS_PRODUCT) == 0 && !read_double(position, end, result))
+			{
+				break;
+			}
+
+			string rates_of = rate_updated_at != 0 ? format_utc(rate_updated_at, 0) : "";
+			// Empty for the latest rate
+			string window = rate_window_seconds > 0 ? format_window(rate_window_seconds) : "";
+			if (format == AuditFormat::Csv)
+			{
+				stream << std::format("{},{},{},{},{},{},{},{}", format_utc_nanoseconds(at), source, target, amount, rate, rates_of, result, window) << '\n';
+			}
+			else
+			{
+				stream << std::format("{}  {} {} = {} {}  ", format_utc_nanoseconds(at), amount, source, result, target);
+				if (!window.empty())
+				{
+					stream << window << " average ";
+				}
+				stream << "rate " << std::format("{}", rate);
+				if (!rates_of.empty())
+				{
+					stream << (window.empty() ? " of " : " until ") << rates_of;
+				}
+				stream << '\n';
+			}
+		}
+		return true;
+	}
+
+	bool decode_audit_log(const string& path, std::ostream& stream, AuditFormat format)
+	{
+		std::vector<string> paths {};
+		std::error_code error;
+		if (std::filesystem::is_directory(path, error))
+		{
+			for (auto& entry : std::filesystem::directory_iterator(path, error))
+			{
+				if (entry.path().extension() == ".ccal")
+				{
+					paths.push_back(entry.path().string());
+				}
+			}
+			// File names start with the time the log was opened
+			std::sort(paths.begin(), paths.end());
+		}
+		else
+		{
+			paths.push_back(path);
+		}
+
+		if (format == AuditFormat::Csv)
+		{
+			stream << "time,source,target,amount,rate,rates_updated_at,result,rate_window" << '\n';
+		}
+		for (auto& file_path : paths)
+		{
+			if (!decode_audit_file(file_path, stream, format))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
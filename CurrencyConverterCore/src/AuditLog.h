@@ -0,0 +1,167 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <fstream>
+#include <ostream>
+#include <cstdint>
+
+namespace CurrencyConverter
+{
+	using std::string;
+
+	// Audit log files: "CCAL", version byte, then records until the end of the file.
+	// Every record starts with a flags byte. Fields are left out when the flags say they didn't change:
+	//     nanoseconds since the previous record (zigzag varint, records of several threads aren't sorted)
+	//     source and target code                         unless AUDIT_SAME_PAIR. AUDIT_SOURCE_CUT / AUDIT_TARGET_CUT if it didn't fit into the record.
+	//     rate (double), rate timestamp (zigzag varint delta)  unless AUDIT_SAME_RATE
+	//     window of the average rate in seconds (varint)  only with AUDIT_AVERAGE_RATE, which comes with the rate
+	//     amount (double)
+	//     result (double)                                unless AUDIT_RESULT_IS_PRODUCT
+	// AUDIT_LOST records only hold the time and the number of conversions that couldn't be logged (varint).
+	// "Previous record" starts over in every file, so every file can be decoded on its own.
+	constexpr const char* AUDIT_MAGIC = "CCAL";
+	// Version 2 added AUDIT_SOURCE_CUT and AUDIT_TARGET_CUT, version 3 AUDIT_AVERAGE_RATE. Older files decode the same way.
+	constexpr uint8_t AUDIT_VERSION = 3;
+
+	constexpr uint8_t AUDIT_SAME_PAIR = 0x01;
+	constexpr uint8_t AUDIT_SAME_RATE = 0x02;
+	constexpr uint8_t AUDIT_RESULT_IS_PRODUCT = 0x04;
+	constexpr uint8_t AUDIT_SOURCE_CUT = 0x08;
+	constexpr uint8_t AUDIT_TARGET_CUT = 0x10;
+	constexpr uint8_t AUDIT_AVERAGE_RATE = 0x20;
+	constexpr uint8_t AUDIT_LOST = 0x80;
+
+	// Bytes per currency code including the terminating zero, like RATE_TABLE_CODE_SIZE
+	constexpr size_t AUDIT_CODE_SIZE = 8;
+
+	// Conversions every thread can buffer before the flusher picks them up. 4.5 MB per converting thread.
+	constexpr uint64_t AUDIT_RING_CAPACITY = 65536;
+
+	// One conversion. Fixed size so that it can be copied into the ring buffer without allocating.
+	struct AuditRecord {
+		// Unix time in nanoseconds
+		int64_t at;
+		double amount;
+		double rate;
+		double result;
+		// Unix time in seconds of the rates used. 0 if unknown. For an average rate the end of its window.
+		int64_t rate_updated_at;
+		// 0 for the latest rate, otherwise the rate is the time weighted average of this many seconds before rate_updated_at
+		int64_t rate_window_seconds;
+		char source[AUDIT_CODE_SIZE];
+		char target[AUDIT_CODE_SIZE];
+		// Set if the code was longer and got cut. The decoder marks those codes, so they can't be taken for another currency.
+		bool source_cut;
+		bool target_cut;
+	};
+
+	// Lock free buffer between one converting thread and the flusher
+	struct AuditRing {
+		// The converting thread. A thread that comes back to a log after using others gets its ring back.
+		std::thread::id owner;
+		// Only written by the converting thread
+		alignas(64) std::atomic<uint64_t> head;
+		// Tail as last seen by the converting thread. Saves reading the flusher's cache line on every record.
+		uint64_t cached_tail;
+		// Only written by the flusher
+		alignas(64) std::atomic<uint64_t> tail;
+		// Conversions that didn't fit because the ring was full
+		alignas(64) std::atomic<uint64_t> dropped;
+		AuditRecord records[AUDIT_RING_CAPACITY];
+	};
+
+	struct AuditLogOptions {
+		AuditLogOptions();
+
+		// Created if it doesn't exist
+		string directory;
+		// A new file gets started once the current one reaches this size
+		uint64_t max_file_bytes;
+		// How long the flusher sleeps when there was nothing to write
+		uint32_t flush_interval_milliseconds;
+	};
+
+	// Records every conversion for compliance: pair, amount, rate, timestamp of the rate and result.
+	//
+	// record() is called on the conversion path and has to stay cheap: it copies a fixed size record
+	// into a ring buffer of the calling thread and never blocks or allocates (except once for the first record of every thread).
+	// Every thread remembers the rings of the last few logs it recorded to, so alternating between logs stays cheap as well.
+	// A background thread collects the records of all threads, encodes them compactly (see above) and writes them to
+	// rotating files "audit-<utc start time>-<number>.ccal". If a thread converts faster than the flusher
+	// can write, further conversions are counted as lost instead of waiting, and the count is written to the log.
+	// Once a file can't be written or the next one can't be created, every further conversion is counted as lost too.
+	class AuditLog {
+	public:
+		AuditLog();
+		~AuditLog();
+
+		AuditLog(const AuditLog&) = delete;
+		AuditLog& operator=(const AuditLog&) = delete;
+
+		// Starts the flusher. Returns false if the directory or the first file can't be created.
+		bool open(const AuditLogOptions& options);
+		// Writes everything still buffered and stops the flusher. No thread may call record() anymore after this.
+		void close();
+		bool is_open();
+
+		// rate_window_seconds 0 for the latest rate, see AuditRecord
+		void record(const string& source, const string& target, double amount, double rate, int64_t rate_updated_at, double result, int64_t rate_window_seconds = 0);
+
+		uint64_t written_count();
+		uint64_t lost_count();
+		uint64_t file_count();
+
+	private:
+		// Tells the thread local ring pointers of different logs apart
+		uint64_t id;
+		AuditLogOptions options;
+
+		std::mutex rings_mutex;
+		// One per thread that recorded to this log
+		std::vector<std::unique_ptr<AuditRing>> rings;
+
+		std::thread flusher;
+		std::atomic<bool> running;
+
+		// Everything below is only used by the flusher
+		std::ofstream file;
+		uint64_t file_bytes;
+		string file_prefix;
+		// Previous record of the current file
+		AuditRecord previous;
+		string buffer;
+		// Conversions in buffer. Counted as written once the buffer made it into the file.
+		uint64_t buffered_records;
+		// Set when writing or creating a file failed. Stops writing for good.
+		bool failed;
+		// Copy of rings, so that the mutex isn't held while encoding
+		std::vector<AuditRing*> drained_rings;
+
+		std::atomic<uint64_t> written;
+		std::atomic<uint64_t> lost;
+		std::atomic<uint64_t> files;
+
+		AuditRing* register_thread();
+		void run_flusher();
+		// Returns the number of records taken out of the rings
+		uint64_t drain();
+		void encode(const AuditRecord& record);
+		void encode_lost(uint64_t count);
+		void write_buffer();
+		// Sets failed if the file can't be created
+		bool open_next_file();
+	};
+
+	enum class AuditFormat {
+		Text,
+		Csv
+	};
+
+	// Writes the records of an audit log file as text or csv. A directory decodes all its audit log files in order.
+	// Returns false if something isn't an audit log file.
+	bool decode_audit_log(const string& path, std::ostream& stream, AuditFormat format);
+}
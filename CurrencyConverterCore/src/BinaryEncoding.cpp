@@ -0,0 +1,83 @@
+#include "BinaryEncoding.h"
+#include <cstring>
+
+namespace CurrencyConverter
+{
+	void write_varint(string& buffer, uint64_t value)
+	{
+		while (value >= 0x80)
+		{
+			buffer.push_back((char)((value & 0x7f) | 0x80));
+			value >>= 7;
+		}
+		buffer.push_back((char)value);
+	}
+
+	bool read_varint(const char*& position, const char* end, uint64_t& value)
+	{
+		value = 0;
+		for (int shift = 0; shift < 64; shift += 7)
+		{
+			if (position >= end)
+			{
+				return false;
+			}
+			uint8_t byte = (uint8_t)*position;
+			position++;
+			value |= (uint64_t)(byte & 0x7f) << shift;
+			if ((byte & 0x80) == 0)
+			{
+				return true;
+			}
+		}
+		// More than 10 bytes can't be a valid varint
+		return false;
+	}
+
+	uint64_t zigzag_encode(int64_t value)
+	{
+		return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+	}
+
+	int64_t zigzag_decode(uint64_t value)
+	{
+		return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+	}
+
+	void write_bytes(string& buffer, std::string_view bytes)
+	{
+		write_varint(buffer, bytes.size());
+		buffer.append(bytes.data(), bytes.size());
+	}
+
+	bool read_bytes(const char*& position, const char* end, string& bytes)
+	{
+		uint64_t length = 0;
+		if (!read_varint(position, end, length) || length > (uint64_t)(end - position))
+		{
+			return false;
+		}
+		bytes.assign(position, (size_t)length);
+		position += length;
+		return true;
+	}
+
+	void write_double(string& buffer, double value)
+	{
+		// Every platform this program runs on is little endian, so the bytes can be copied as they are
+		char bytes[sizeof(double)];
+		memcpy(bytes, &value, sizeof(double));
+		buffer.append(bytes, sizeof(double));
+	}
+
+	bool read_double(const char*& position, const char* end, double& value)
+	{
+		if ((size_t)(end - position) < sizeof(double))
+		{
+			return false;
+		}
+		memcpy(&value, position, sizeof(double));
+		position += sizeof(double);
+		return true;
+	}
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+namespace CurrencyConverter
+{
+	using std::string;
+
+	// Helpers for the compact binary files of this program (session traces, audit logs).
+	// Writers append to a string buffer. Readers advance position and return false at the end of the data or on garbage.
+	//
+	// Integers are written as varints: 7 bits per byte, lowest bits first, high bit set on every byte but the last.
+	// Small numbers like time deltas or lengths take a single byte that way.
+
+	void write_varint(string& buffer, uint64_t value);
+	bool read_varint(const char*& position, const char* end, uint64_t& value);
+
+	// Maps signed numbers to unsigned ones so that small negative numbers stay small: 0, -1, 1, -2, 2 -> 0, 1, 2, 3, 4
+	uint64_t zigzag_encode(int64_t value);
+	int64_t zigzag_decode(uint64_t value);
+
+	// Varint length followed by the bytes
+	void write_bytes(string& buffer, std::string_view bytes);
+	bool read_bytes(const char*& position, const char* end, string& bytes);
+
+	// 8 bytes, little endian
+	void write_double(string& buffer, double value);
+	bool read_double(const char*& position, const char* end, double& value);
+}
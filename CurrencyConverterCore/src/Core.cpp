@@ -0,0 +1,700 @@
+#include "Core.h"
+#include <iostream>
+#include <sstream>
+#include <ctime>
+#include <memory>
+#include <future>
+#include <windows.h>
+
+// Library for json parsing
+#include <nlohmann/json.hpp>
+// Library for making https requests
+#include <curlpp/Options.hpp>
+#include <curlpp/Infos.hpp>
+
+#include "AllocationTracker.h"
+
+using namespace curlpp::options;
+using json = nlohmann::json;
+
+namespace CurrencyConverter
+{
+	// This function runs all requests needed at program start concurrently.
+	// The status, the currency list and the exchange rates of every currency in prefetch_bases are requested at the same time,
+	// so the startup takes as long as the slowest request instead of the sum of all of them.
+	void start_up(AppState& app_state, const std::vector<string>& prefetch_bases)
+	{
+		// Replayed sessions don't touch the network, so they don't need a fetcher (nor curl) at all
+		std::unique_ptr<AsyncFetcher> fetcher = app_state.response_replay == nullptr ? std::make_unique<AsyncFetcher>() : nullptr;
+		auto fetch = [&app_state, &fetcher](const string& endpoint, const std::list<string>& headers, const string& request_name) {
+			if (fetcher == nullptr)
+			{
+				std::promise<FetchResponse> replayed;
+				replayed.set_value(app_state.response_replay->next(request_name));
+				return replayed.get_future();
+			}
+			return fetcher->fetch(app_state.api_url + endpoint, headers);
+		};
+
+		// The account data of every key is needed to spread the requests by remaining quota
+		std::vector<std::future<FetchResponse>> statuses {};
+		for (auto& api_key : app_state.api_keys.keys)
+		{
+			statuses.push_back(fetch("/status", get_api_key_headers(api_key.key), "/status"));
+		}
+
+		// Quotas aren't known yet so these requests simply take turns on the keys
+		ApiKey* currencies_key = acquire_api_key(app_state);
+		if (currencies_key == nullptr)
+		{
+			throw new std::runtime_error("No usable API key left!");
+		}
+		auto currencies = fetch("/currencies", get_currencies_headers(app_state, currencies_key->key), "/currencies");
+
+		struct PrefetchedRates {
+			string code;
+			ApiKey* api_key;
+			std::future<FetchResponse> response;
+		};
+		std::vector<PrefetchedRates> exchange_rates {};
+		for (auto& code : prefetch_bases)
+		{
+			ApiKey* api_key = acquire_api_key(app_state);
+			if (api_key == nullptr)
+			{
+				throw new std::runtime_error("No usable API key left!");
+			}
+			exchange_rates.push_back({ code, api_key, fetch("/latest", get_exchange_rates_headers(app_state, api_key->key, code), "/latest?base_currency=" + code) });
+		}
+
+		// All requests are in flight at the same time here
+		if (fetcher != nullptr)
+		{
+			fetcher->run();
+		}
+
+		// Responses get handled in the same order as a sequential startup would do it
+		// because the exchange rates can only be parsed once the currency list is known.
+		for (size_t i = 0; i < statuses.size(); i++)
+		{
+			ApiKey& api_key = app_state.api_keys.keys[i];
+			FetchResponse status_response = statuses[i].get();
+			record_response(app_state, "/status", status_response);
+			write_transport_error(status_response);
+			if (fail_over_api_key(app_state, api_key, status_response.response_code))
+			{
+				continue;
+			}
+			if (!handle_api_status_response(app_state, api_key, status_response))
+			{
+				// Server error. The blocking version knows how to retry.
+				check_api_status(app_state, api_key);
+			}
+		}
+
+		// Requests that were rejected because of their key get repeated with another key by the blocking versions
+		FetchResponse currencies_response = currencies.get();
+		record_response(app_state, "/currencies", currencies_response);
+		write_transport_error(currencies_response);
+		if (fail_over_api_key(app_state, *currencies_key, currencies_response.response_code))
+		{
+			get_currencies(app_state, true);
+		}
+		else
+		{
+			handle_currencies_response(app_state, *currencies_key, currencies_response);
+		}
+
+		for (auto& entry : exchange_rates)
+		{
+			FetchResponse response = entry.response.get();
+			record_response(app_state, "/latest?base_currency=" + entry.code, response);
+			if (!app_state.currencies.contains(entry.code))
+			{
+				std::cerr << "\n\tUnknown currency code " << entry.code << ". No exchange rates prefetched for it." << "\n";
+				continue;
+			}
+			write_transport_error(response);
+			if (fail_over_api_key(app_state, *entry.api_key, response.response_code))
+			{
+				get_exchange_rates(app_state, app_state.currencies[entry.code]);
+			}
+			else
+			{
+				handle_exchange_rates_response(app_state, *entry.api_key, app_state.currencies[entry.code], response);
+			}
+		}
+	}
+
+	// This function takes an api key out of rotation after it got rejected with 401 or 429.
+	// Returns true if the request should be repeated with another key.
+	// Returns false for any other response or if there is no key left. Then the response handler reports the error as usual.
+	bool fail_over_api_key(AppState& app_state, ApiKey& api_key, long response_code)
+	{
+		if (response_code != 401 && response_code != 429)
+		{
+			return false;
+		}
+		// A key that is already out of rotation (e.g. marked by another response) doesn't need to be reported twice.
+		// Which key comes next is up to acquire_api_key(). Asking the pool here would already count as a use of that key.
+		if (api_key.state != ApiKeyState::Active)
+		{
+			return app_state.api_keys.active_count() > 0;
+		}
+
+		bool other_key_left = app_state.api_keys.fail_over(api_key, response_code);
+		if (other_key_left)
+		{
+			std::cerr << "\n\tApi key was rejected with " << response_code << " (" << api_key.state_name() << "). Switching to another key." << "\n";
+		}
+		return other_key_left;
+	}
+
+	// This function refreshes the currency list and the exchange rates of every currency that has cached rates.
+	// All requests are conditional, so unchanged data is neither downloaded nor parsed again.
+	void refresh_data(AppState& app_state)
+	{
+		get_currencies(app_state, true);
+
+		for (auto& element : app_state.currencies)
+		{
+			if (!element.second.exchange_rates.empty())
+			{
+				get_exchange_rates(app_state, element.second);
+			}
+		}
+	}
+
+	// This function writes the reason of a failed transfer to the console
+	void write_transport_error(const FetchResponse& response)
+	{
+		if (!response.error.empty())
+		{
+			std::cerr << "\n\n\tRequest failed: " << response.error << "\n";
+		}
+	}
+
+	// This function sends a single request and waits for its response.
+	// In a replayed session the response comes from the trace instead, in a recorded one it gets written to the trace.
+	FetchResponse fetch_blocking(AppState& app_state, const string& endpoint, const std::list<string>& headers, const string& request_name)
+	{
+		if (app_state.response_replay != nullptr)
+		{
+			return app_state.response_replay->next(request_name);
+		}
+
+		// Class that handles memory initialization and deletion.
+		curlpp::Cleanup cleaner;
+
+		// Set target url and headers of the request
+		curlpp::Easy request;
+		request.setOpt(new Url(app_state.api_url + endpoint));
+		request.setOpt(new HttpHeader(headers));
+
+		// Memory location to store the incoming response body
+		std::stringstream response_body;
+		// Set the response stream as output stream of the request
+		request.setOpt(cURLpp::Options::WriteStream(&response_body));
+		// Response headers are needed for the validators (ETag, Last-Modified)
+		std::string response_headers = "";
+		request.setOpt(new HeaderFunction(get_header_collector(response_headers)));
+
+		request.perform();
+
+		FetchResponse response {};
+		response.response_code = curlpp::infos::ResponseCode::get(request);
+		response.headers = response_headers;
+		response.body = response_body.str();
+		record_response(app_state, request_name, response);
+		return response;
+	}
+
+	// This function writes a command of the user to the trace if the session gets recorded
+	void record_event(AppState& app_state, TraceEventType type, const std::vector<string>& codes, double amount)
+	{
+		if (app_state.trace_recorder != nullptr)
+		{
+			app_state.trace_recorder->record(type, codes, amount);
+		}
+	}
+
+	// This function writes a response of the api to the trace if the session gets recorded
+	void record_response(AppState& app_state, const string& request_name, const FetchResponse& response)
+	{
+		if (app_state.trace_recorder != nullptr)
+		{
+			app_state.trace_recorder->record_response(request_name, response);
+		}
+	}
+
+	// This function fetches all exchange rates for a given currency
+	// The currency is defined by it's currency code
+	// All exchange rates will be fetched to reduce the number of api calls
+	void get_exchange_rates(AppState& app_state, Currency& currency)
+	{
+		AllocationScope allocation_scope(AllocationTag::Fetch);
+
+		// Upstream only publishes new rates once a day. If the cached ones are younger than that there is nothing to fetch,
+		// unless currencies got added since. Their rates are in the response already.
+		string validators_key = EXCHANGE_RATES_VALIDATORS_KEY + currency.code;
+		if (!currency.exchange_rates.empty() && rates_cover_currency_list(app_state, currency) && app_state.fetch_validators.contains(validators_key)
+			&& !exchange_rates_may_have_changed(app_state.fetch_validators[validators_key], app_state.now(), app_state.rates_update_interval))
+		{
+			return;
+		}
+
+		// Repeats the request with another key if the current one gets rejected
+		while (true)
+		{
+			ApiKey* api_key = acquire_api_key(app_state);
+			if (api_key == nullptr)
+			{
+				throw new std::runtime_error("No usable API key left!");
+			}
+
+			// Send request and get a result. Headers are the api key and the currency.
+			FetchResponse response = fetch_blocking(app_state, "/latest", get_exchange_rates_headers(app_state, api_key->key, currency.code), "/latest?base_currency=" + currency.code);
+
+			if (fail_over_api_key(app_state, *api_key, response.response_code))
+			{
+				continue;
+			}
+
+			handle_exchange_rates_response(app_state, *api_key, currency, response);
+			return;
+		}
+	}
+
+	// Returns false if currencies were added to the list after the rates of currency were parsed
+	bool rates_cover_currency_list(AppState& app_state, const Currency& currency)
+	{
+		return currency.rates_currency_list_version == app_state.currency_list_version;
+	}
+
+	// Returns the key the next request should use or nullptr if every key got rejected.
+	// Callers decide how to report that (the C api returns CC_ERROR_NO_API_KEY for it).
+	ApiKey* acquire_api_key(AppState& app_state)
+	{
+		ApiKey* api_key = app_state.api_keys.acquire();
+		if (api_key == nullptr)
+		{
+			std::cerr << "\n\n\tAll API keys are invalid or rate limited! Try again next month or upgrade your plan." << "\n";
+		}
+		return api_key;
+	}
+
+	// Headers for the latest exchange rates endpoint. Here this is the api key and the currency.
+	// If rates of the currency are cached the request becomes conditional. A 304 can't bring rates of currencies added since.
+	std::list<string> get_exchange_rates_headers(AppState& app_state, const string& api_key, const string& base_code)
+	{
+		std::list<string> headers {};
+		headers.push_back("apikey: " + api_key);
+		headers.push_back("base_currency: " + base_code);
+
+		string validators_key = EXCHANGE_RATES_VALIDATORS_KEY + base_code;
+		if (app_state.currencies.contains(base_code) && !app_state.currencies[base_code].exchange_rates.empty()
+			&& rates_cover_currency_list(app_state, app_state.currencies[base_code]) && app_state.fetch_validators.contains(validators_key))
+		{
+			add_conditional_headers(headers, app_state.fetch_validators[validators_key]);
+		}
+		return headers;
+	}
+
+	// Returns a curl header callback that appends every header line to response_headers
+	curlpp::types::WriteFunctionFunctor get_header_collector(std::string& response_headers)
+	{
+		return [&response_headers](char* data, size_t size, size_t count) {
+			response_headers.append(data, size * count);
+			return size * count;
+		};
+	}
+
+	// This function writes the response of the latest exchange rates endpoint into the given currency
+	void handle_exchange_rates_response(AppState& app_state, ApiKey& api_key, Currency& currency, const FetchResponse& response)
+	{
+		AllocationScope allocation_scope(AllocationTag::Parse);
+
+		FetchValidators& validators = app_state.fetch_validators[EXCHANGE_RATES_VALIDATORS_KEY + currency.code];
+
+		// Handling the possible response codes.
+		// Error 403 (Not allowed), 422 (Validation Error) can't / shouldn't happen at this endpoint.
+		// Error 404 may happen if the url got changed.
+		switch (response.response_code)
+		{
+			// Happy case. Write received data to AppState and return.
+			// Curly braces are needed so that a scope is properly created and memory can be properly initialized and deleted
+			case 200:
+				{
+					// Example response body
+					// {"meta":{"last_updated_at":"2022-01-01T23:59:59Z"},"data":{"AED":3.67306,"AFN":91.80254,"ALL":108.22904,"AMD":480.41659,"...":"150+ more currencies"}}
+
+					read_validators(response.headers, validators);
+					validators.last_updated_at = find_last_updated_at(response.body);
+
+					// Update the used and reamining quotas since a successful query was made
+					api_key.count_request();
+
+					// Same timestamp as the cached rates means same rates. No need to parse them again,
+					// unless currencies got added to the list since. Their rates are in this body already.
+					if (!currency.exchange_rates.empty() && rates_cover_currency_list(app_state, currency)
+						&& !validators.last_updated_at.empty() && validators.last_updated_at == currency.rates_last_updated_at)
+					{
+						return;
+					}
+
+					// Parse response body
+					auto parsed_body = json::parse(response.body);
+
+					// Iterating over available currencies to get the key with which the parsed json gets accessed.
+					// The rates get replaced as a whole, so a currency upstream stopped quoting doesn't keep its old rate.
+					std::map<string, float> exchange_rates;
+					auto& data = parsed_body["data"];
+					for (auto& element : app_state.currencies)
+					{
+						auto rate = data.find(element.first);
+						if (rate != data.end() && rate->is_number())
+						{
+							exchange_rates[element.first] = *rate;
+						}
+					}
+					currency.exchange_rates = std::move(exchange_rates);
+					currency.rates_currency_list_version = app_state.currency_list_version;
+
+					// Remember when upstream last updated these rates
+					if (parsed_body.contains("meta"))
+					{
+						currency.rates_last_updated_at = parsed_body["meta"]["last_updated_at"];
+					}
+					currency.rates_updated_at = parse_api_timestamp(currency.rates_last_updated_at);
+
+					// Make the new rates visible to lock free readers (and other processes in publisher mode)
+					app_state.rate_table.update_row(currency.code, currency.exchange_rates, currency.rates_updated_at != 0 ? currency.rates_updated_at : app_state.now());
+					return;
+				}
+			// Not modified. The cached rates are still up to date.
+			case 304:
+				return;
+				// Invalid api key. This should trigger a program termination.
+			case 401:
+				std::cerr << "\n\n\tInvalid API key! Please check your key." << "\n";
+				throw new std::runtime_error("Invalid API key!");
+			// Endpoint doesn't exist. This should trigger a program termination.
+			case 404:
+				std::cerr << "\n\n\tLatest exchange rate API endpoint doesn't exist anymore! Please check the api documentation for changes." << "\n";
+				throw new std::runtime_error("Latest API endpoint doesn't exist!");
+			// Used up all quotas
+			case 429:
+				std::cerr << "\n\n\tYou have reached your rate limit! Try again next month or upgrade your plan." << "\n";
+				throw new std::runtime_error("Rate limit reached!");
+			// Some kind of server error. This should trigger a retry or a program termination if enough retrys are reached.
+			case 500:
+				// No retry here since the status endpoint worked at program initialization.
+				// So just terminate the program.
+				std::cerr << "\n\n\tServer error! Terminating program. Please try again later." << "\n";
+				throw new std::runtime_error("Latest API endpoint not reachable!");
+			// Any other unexpected response code. This should trigger a program termination.
+			default:
+				std::cerr << "\n\n\tUnexpected error!" << "\n";
+				throw new std::runtime_error("Unexpected error!");
+		}
+	}
+
+	// This function converts an amount with the cached exchange rates of the source currency.
+	// The exchange rates of the source currency have to be fetched already.
+	// Doesn't allocate anything so that conversions stay cheap when done in bulk.
+	// Every conversion goes to the audit log if there is one. That only copies a record into a buffer, see AuditLog.h.
+	// With twap_window_seconds the time weighted average rate of that window gets used instead of the latest rate, e.g. 86400 for the 24h TWAP.
+	double convert_money(AppState& app_state, const string& source_currency, const string& target_currency, double amount, int64_t twap_window_seconds)
+	{
+		AllocationScope allocation_scope(AllocationTag::Convert);
+
+		Currency& source = app_state.currencies.at(source_currency);
+		double rate = source.exchange_rates.at(target_currency);
+		int64_t rate_updated_at = source.rates_updated_at;
+		if (twap_window_seconds > 0)
+		{
+			RateStatistics statistics {};
+			// The average is valid until now, not until the latest rates
+			rate_updated_at = app_state.now();
+			if (!app_state.rate_analytics.get_statistics(source_currency, target_currency, twap_window_seconds, rate_updated_at, statistics))
+			{
+				std::cerr << "\n\tNo " << format_window(twap_window_seconds) << " average rate for " << source_currency << " to " << target_currency << "." << "\n";
+				throw new std::runtime_error("No average rate for this window!");
+			}
+			rate = statistics.twap;
+		}
+		double result = amount * rate;
+		if (app_state.audit_log != nullptr)
+		{
+			app_state.audit_log->record(source_currency, target_currency, amount, rate, rate_updated_at, result, twap_window_seconds);
+		}
+		return result;
+	}
+
+	// This function loads the currency list into the app_state if needed.
+	void get_currencies(AppState& app_state, bool forced)
+	{
+		// If this function isn't doing a forced update and currencies are already loaded
+		// then nothing needs to be done
+		if (!forced && !app_state.currencies.empty())
+		{
+			return;
+		}
+
+		// Fetch new data
+		AllocationScope allocation_scope(AllocationTag::Fetch);
+
+		// Repeats the request with another key if the current one gets rejected
+		while (true)
+		{
+			ApiKey* api_key = acquire_api_key(app_state);
+			if (api_key == nullptr)
+			{
+				throw new std::runtime_error("No usable API key left!");
+			}
+
+			// Send request and get a result. Headers are the api key and the validators of the cached currency list.
+			FetchResponse response = fetch_blocking(app_state, "/currencies", get_currencies_headers(app_state, api_key->key), "/currencies");
+
+			if (fail_over_api_key(app_state, *api_key, response.response_code))
+			{
+				continue;
+			}
+
+			handle_currencies_response(app_state, *api_key, response);
+			return;
+		}
+	}
+
+	// Headers for the currencies endpoint. Conditional if a currency list is cached already.
+	std::list<string> get_currencies_headers(AppState& app_state, const string& api_key)
+	{
+		std::list<string> headers = get_api_key_headers(api_key);
+		if (!app_state.currencies.empty() && app_state.fetch_validators.contains(CURRENCIES_VALIDATORS_KEY))
+		{
+			add_conditional_headers(headers, app_state.fetch_validators[CURRENCIES_VALIDATORS_KEY]);
+		}
+		return headers;
+	}
+
+	// Headers for endpoints that only need the api key.
+	std::list<string> get_api_key_headers(const string& api_key)
+	{
+		std::list<string> headers {};
+		headers.push_back("apikey: " + api_key);
+		return headers;
+	}
+
+	// This function replaces the currency list in app_state with the response of the currencies endpoint
+	void handle_currencies_response(AppState& app_state, ApiKey& api_key, const FetchResponse& response)
+	{
+		AllocationScope allocation_scope(AllocationTag::Parse);
+
+		// Handling the possible response codes.
+		// Error 403 (Not allowed), 422 (Validation Error) can't / shouldn't happen at this endpoint.
+		// Error 404 may happen if the url got changed.
+		switch (response.response_code)
+		{
+			// Happy case. Write received data to AppState and return.
+			// Curly braces are needed so that a scope is properly created and memory can be properly initialized and deleted
+			case 200:
+			{
+				// Example response body
+				// {"data":{"AED":{"symbol":"AED","name":"United Arab Emirates Dirham","symbol_native":"د.إ","decimal_digits":2,"rounding":0,"code":"AED","name_plural":"UAE dirhams"},"AFN":{"symbol":"Af","name":"Afghan Afghani","symbol_native":"؋","decimal_digits":0,"rounding":0,"code":"AFN","name_plural":"Afghan Afghanis"},"...":{}}}
+
+				read_validators(response.headers, app_state.fetch_validators[CURRENCIES_VALIDATORS_KEY]);
+
+				// Parse response body
+				auto parsed_body = json::parse(response.body);
+
+				// Construct new currencies from parsed_body
+				std::map<string, Currency> currencies;
+				bool added_currency = false;
+				for (auto& element : parsed_body["data"])
+				{
+					Currency currency = Currency(
+						element["symbol"],
+						element["name"],
+						element["symbol_native"],
+						element["decimal_digits"],
+						element["rounding"],
+						element["code"],
+						element["name_plural"]
+					);
+					std::string code = (string) element["code"];
+					// Cached exchange rates of known currencies survive a refresh of the currency list
+					if (app_state.currencies.contains(code))
+					{
+						currency.exchange_rates = app_state.currencies[code].exchange_rates;
+						currency.rates_last_updated_at = app_state.currencies[code].rates_last_updated_at;
+						currency.rates_updated_at = app_state.currencies[code].rates_updated_at;
+						currency.rates_currency_list_version = app_state.currencies[code].rates_currency_list_version;
+					}
+					else
+					{
+						added_currency = true;
+					}
+					currencies[code] = currency;
+				}
+
+				// Currencies that aren't in the list anymore are dropped, together with the cached rates into them
+				for (auto& element : currencies)
+				{
+					std::erase_if(element.second.exchange_rates, [&currencies](const auto& rate) {
+						return !currencies.contains(rate.first);
+					});
+				}
+				app_state.currencies = std::move(currencies);
+				// Cached rates were parsed without the added currencies
+				if (added_currency)
+				{
+					app_state.currency_list_version++;
+				}
+
+				// Names and symbols of the new currency list become searchable
+				app_state.currency_search.build(app_state.currencies);
+
+				// Currency indices of the rate table follow the new currency list
+				app_state.rate_table.set_currencies(app_state.currencies);
+				for (auto& element : app_state.currencies)
+				{
+					if (!element.second.exchange_rates.empty())
+					{
+						app_state.rate_table.update_row(element.first, element.second.exchange_rates, element.second.rates_updated_at != 0 ? element.second.rates_updated_at : app_state.now());
+					}
+				}
+
+				// Update the used and reamining quotas since a successful query was made
+				api_key.count_request();
+				return;
+			}
+			// Not modified. The cached currency list is still up to date.
+			case 304:
+				return;
+			// Invalid api key. This should trigger a program termination.
+			case 401:
+				std::cerr << "\n\n\tInvalid API key! Please check your key." << "\n";
+				throw new std::runtime_error("Invalid API key!");
+			// Endpoint doesn't exist. This should trigger a program termination.
+			case 404:
+				std::cerr << "\n\n\tCurrency API endpoint doesn't exist anymore! Please check the api documentation for changes." << "\n";
+				throw new std::runtime_error("Currency API endpoint doesn't exist!");
+			// Used up all quotas
+			case 429:
+				std::cerr << "\n\n\tYou have reached your rate limit! Try again next month or upgrade your plan." << "\n";
+				throw new std::runtime_error("Rate limit reached!");
+			// Some kind of server error. This should trigger a retry or a program termination if enough retrys are reached.
+			case 500:
+				// No retry here since the status endpoint worked at program initialization.
+				// So just terminate the program.
+				std::cerr << "\n\n\tServer error! Terminating program. Please try again later." << "\n";
+				throw new std::runtime_error("Currency API endpoint not reachable!");
+			// Any other unexpected response code. This should trigger a program termination.
+			default:
+				std::cerr << "\n\n\tUnexpected error!" << "\n";
+				throw new std::runtime_error("Unexpected error!");
+		}
+	}
+
+	void check_api_status(AppState& app_state, ApiKey& api_key)
+	{
+		AllocationScope allocation_scope(AllocationTag::Fetch);
+
+		// Counter necessary for retrying if the status endpoint fails with error 500
+		// Retry currently after 30 seconds for the case if the problem is intermittent
+		uint8_t retry_count {};
+		uint8_t max_retry_count { 5 };
+
+		while (true)
+		{
+			// Send request and get a result. Headers only contain the api key.
+			FetchResponse response = fetch_blocking(app_state, "/status", get_api_key_headers(api_key.key), "/status");
+			// std::cout << "\nDEBUG: response code --> " << response.response_code << "\n\n";
+
+			if (handle_api_status_response(app_state, api_key, response))
+			{
+				return;
+			}
+
+			// Server error. Check if retry or termination.
+			if (retry_count < max_retry_count)
+			{
+				// Retry
+				std::cerr << "\n\n\tStatus API endpoint not reachable or other server error. Automatic retry in 30 seconds." << "\n";
+				// Wait 30 seconds before restarting the loop.
+				// Sleep takes milliseconds as argument so seconds time 1000.
+				Sleep(30 * 1000);
+				retry_count++;
+				continue;
+			} else
+			{
+				// Program termination
+				std::cerr << "\n\n\tMaximum retries reached. Terminating program. Please try again later." << "\n";
+				throw new std::runtime_error("Status API endpoint not reachable!");
+			}
+		}
+	}
+
+	// This function writes the account data of a status endpoint response into the api key.
+	// Returns false on a server error so that the caller can decide whether to retry.
+	bool handle_api_status_response(AppState& app_state, ApiKey& api_key, const FetchResponse& response)
+	{
+		AllocationScope allocation_scope(AllocationTag::Parse);
+
+		// Handling the possible response codes.
+		// Error 403 (Not allowed), 422 (Validation Error) and 429 (Rate Limit hit) can't / shouldn't happen at this endpoint.
+		// Error 404 may happen if the url got changed.
+		switch (response.response_code)
+		{
+			// Happy case. Write received data to AppState and return.
+			case 200:
+			{
+				// Example response body for freecurrencyapi.com
+				// {"account_id":239344465066725376,"quotas":{"month":{"total":5000,"used":0,"remaining":5000}}}
+				// Example response body for currencyapi.com
+				// {"account_id":239344465066725376,"quotas":{"month":{"total":5000,"used":0,"remaining":5000},"grace":{"total":0,"used":0,"remaining":0}}}
+
+				// Parse response body
+				auto parsed_body = json::parse(response.body);
+				// Fill account info with response data
+				for (auto& element : parsed_body)
+				{
+					// Extract data from json object to cast it readably
+					uint32_t account_id = (uint32_t)parsed_body["account_id"];
+					uint32_t total = (uint32_t)parsed_body["quotas"]["month"]["total"];
+					uint32_t used = (uint32_t)parsed_body["quotas"]["month"]["used"];
+					uint32_t remaining = (uint32_t)parsed_body["quotas"]["month"]["remaining"];
+
+					// Create account object without grace data since this function is fetching from freecurrencyapi.com
+					// which doesn't have grace options.
+					Account account = Account(
+						std::to_string(account_id),
+						total,
+						used,
+						remaining,
+						0, 0, 0
+					);
+
+					// Store account with its key so that requests can be spread by remaining quota
+					api_key.account = account;
+				}
+				return true;
+			}
+			// Invalid api key. This should trigger a program termination.
+			case 401:
+				std::cerr << "\n\n\tInvalid API key! Please check your key." << "\n";
+				throw new std::runtime_error("Invalid API key!");
+			// Endpoint doesn't exist. This should trigger a program termination.
+			case 404:
+				std::cerr << "\n\n\tStatus API endpoint doesn't exist anymore! Please check the api documentation for changes." << "\n";
+				throw new std::runtime_error("Status API endpoint doesn't exist!");
+			// Some kind of server error. This should trigger a retry or a program termination if enough retrys are reached.
+			case 500:
+				return false;
+			// Any other unexpected response code. This should trigger a program termination.
+			default:
+				std::cerr << "\n\n\tUnexpected error!" << "\n";
+				throw new std::runtime_error("Unexpected error!");
+		}
+	}
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <list>
+
+#include <curlpp/cURLpp.hpp>
+#include <curlpp/Easy.hpp>
+
+#include "AppState.h"
+#include "AsyncFetch.h"
+#include "SessionTrace.h"
+
+namespace CurrencyConverter
+{
+	using std::string;
+
+	// Everything the program does with the api: fetching, parsing into AppState and converting.
+	// Used by the interactive exe and by the C api in CurrencyConverterApi. Neither reads from the console.
+	// Errors are reported on std::cerr and then thrown as "new std::runtime_error(...)" like everywhere else in this program.
+
+	// Startup and refreshing
+	void start_up(AppState& app_state, const std::vector<string>& prefetch_bases);
+	void refresh_data(AppState& app_state);
+
+	// Api key rotation
+	bool fail_over_api_key(AppState& app_state, ApiKey& api_key, long response_code);
+	ApiKey* acquire_api_key(AppState& app_state);
+
+	// Exchange rates
+	void get_exchange_rates(AppState& app_state, Currency& currency);
+	bool rates_cover_currency_list(AppState& app_state, const Currency& currency);
+	std::list<string> get_exchange_rates_headers(AppState& app_state, const string& api_key, const string& base_code);
+	void handle_exchange_rates_response(AppState& app_state, ApiKey& api_key, Currency& currency, const FetchResponse& response);
+	double convert_money(AppState& app_state, const string& source_currency, const string& target_currency, double amount, int64_t twap_window_seconds = 0);
+
+	// Currencies
+	void get_currencies(AppState& app_state, bool forced = false);
+	std::list<string> get_currencies_headers(AppState& app_state, const string& api_key);
+	void handle_currencies_response(AppState& app_state, ApiKey& api_key, const FetchResponse& response);
+
+	// Account status
+	void check_api_status(AppState& app_state, ApiKey& api_key);
+	bool handle_api_status_response(AppState& app_state, ApiKey& api_key, const FetchResponse& response);
+
+	// Session traces. Every request has a name its response gets recorded and replayed under:
+	// "/status", "/currencies" and "/latest?base_currency=" + code.
+	FetchResponse fetch_blocking(AppState& app_state, const string& endpoint, const std::list<string>& headers, const string& request_name);
+	void record_event(AppState& app_state, TraceEventType type, const std::vector<string>& codes = {}, double amount = 0.0);
+	void record_response(AppState& app_state, const string& request_name, const FetchResponse& response);
+
+	// Helpers for the requests above
+	std::list<string> get_api_key_headers(const string& api_key);
+	curlpp::types::WriteFunctionFunctor get_header_collector(std::string& response_headers);
+	void write_transport_error(const FetchResponse& response);
+}
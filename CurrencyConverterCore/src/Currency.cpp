@@ -11,6 +11,10 @@ namespace CurrencyConverter
 		this->rounding = 0;
 		this->code = "";
 		this->name_plural = "";
+		this->rates_last_updated_at = "";
+		this->rates_updated_at = 0;
+		this->rates_currency_list_version = 0;
+		this->money_format = make_money_format(this->symbol, this->decimal_digits);
 	}
 	Currency::Currency(string symbol, string name, string symbol_native, uint8_t decimal_digits, uint8_t rounding, string code, string name_plural) {
 		this->symbol = symbol;
@@ -20,6 +24,10 @@ namespace CurrencyConverter
 		this->rounding = rounding;
 		this->code = code;
 		this->name_plural = name_plural;
+		this->rates_last_updated_at = "";
+		this->rates_updated_at = 0;
+		this->rates_currency_list_version = 0;
+		this->money_format = make_money_format(this->symbol, this->decimal_digits);
 	}
 
 	Currency::~Currency() {
@@ -37,9 +45,9 @@ namespace CurrencyConverter
 			   this->code.c_str(),
 			   this->name_plural.c_str());
 		std::cout << "    Exchange rates:" << std::endl;
-		for (auto entry : this->exchange_rates)
+		for (auto& entry : this->exchange_rates)
 		{
-			std::cout << std::setw(4) << "    -> " << entry.first << ": " << entry.second << std::endl;
+			std::cout << std::setw(4) << "    -> " << entry.first << ": " << entry.second << '\n';
 		}
 	}
 }
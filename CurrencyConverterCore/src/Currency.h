@@ -5,6 +5,8 @@
 #include <windows.h>
 #include <iomanip>
 
+#include "MoneyCodec.h"
+
 namespace CurrencyConverter
 {
 	using std::string;
@@ -26,5 +28,14 @@ namespace CurrencyConverter
 		string name_plural;
 
 		std::map<string, float> exchange_rates;
+		// meta.last_updated_at of the fetched exchange rates
+		string rates_last_updated_at;
+		// Same as unix time. 0 if unknown.
+		int64_t rates_updated_at;
+		// AppState::currency_list_version the rates were parsed with. Older rates lack the currencies added since.
+		uint64_t rates_currency_list_version;
+
+		// Formatting template for amounts of this currency. Built once on construction.
+		MoneyFormat money_format;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,298 @@
+#include "CurrencySearch.h"
+#include <algorithm>
+
+namespace CurrencyConverter
+{
+	// Scores of the different kinds of matches. A field weight gets added to all of them except EXACT_CODE_SCORE.
+	constexpr int EXACT_CODE_SCORE = 1000;
+	constexpr int EXACT_FIELD_SCORE = 900;
+	constexpr int PREFIX_SCORE = 700;
+	constexpr int WORD_PREFIX_SCORE = 500;
+	// Fuzzy matches get between FUZZY_SCORE and FUZZY_SCORE + FUZZY_RANGE depending on how similar they are
+	constexpr int FUZZY_SCORE = 100;
+	constexpr int FUZZY_RANGE = 300;
+	// Share of common trigrams (dice coefficient) a fuzzy match needs at least
+	constexpr double FUZZY_MIN_SIMILARITY = 0.5;
+	// Shorter queries have too few trigrams to tell currencies apart
+	constexpr size_t FUZZY_MIN_QUERY_LENGTH = 3;
+
+	static const int field_weights[] = { 40, 30, 20, 10, 5 };
+
+	string normalize_search_text(std::string_view text)
+	{
+		string normalized = "";
+		normalize_search_text(text, normalized);
+		return normalized;
+	}
+
+	void normalize_search_text(std::string_view text, string& normalized)
+	{
+		normalized.clear();
+		normalized.reserve(text.size());
+		bool pending_space = false;
+		for (char c : text)
+		{
+			if (c == ' ' || c == '\t' || c == '\r' || c == '\n')
+			{
+				pending_space = !normalized.empty();
+				continue;
+			}
+			if (pending_space)
+			{
+				normalized.push_back(' ');
+				pending_space = false;
+			}
+			normalized.push_back(c >= 'A' && c <= 'Z' ? (char)(c - 'A' + 'a') : c);
+		}
+	}
+
+	// All distinct trigrams of the text padded with a space on both sides, so that word starts and ends count too
+	static void get_trigrams(const string& text, std::vector<uint32_t>& result)
+	{
+		result.clear();
+		size_t padded_size = text.size() + 2;
+		auto byte_at = [&text, padded_size](size_t i) {
+			return (uint32_t)(uint8_t)(i == 0 || i == padded_size - 1 ? ' ' : text[i - 1]);
+		};
+		for (size_t i = 0; i + 3 <= padded_size; i++)
+		{
+			result.push_back((byte_at(i) << 16) | (byte_at(i + 1) << 8) | byte_at(i + 2));
+		}
+		std::sort(result.begin(), result.end());
+		result.erase(std::unique(result.begin(), result.end()), result.end());
+	}
+
+	CurrencySearch::CurrencySearch()
+	{
+		this->trie.push_back(TrieNode());
+	}
+
+	CurrencySearch::~CurrencySearch()
+	{
+	}
+
+	void CurrencySearch::build(const std::map<string, Currency>& currencies)
+	{
+		this->codes.clear();
+		this->trie.clear();
+		this->trie.push_back(TrieNode());
+		this->exact.clear();
+		this->trigrams.clear();
+		this->trigram_counts.assign(currencies.size() * FieldCount, 0);
+
+		uint16_t entry = 0;
+		for (auto& element : currencies)
+		{
+			const Currency& currency = element.second;
+			this->codes.push_back(element.first);
+			this->add_field(entry, CodeField, element.first);
+			this->add_field(entry, NameField, currency.name);
+			this->add_field(entry, NamePluralField, currency.name_plural);
+			this->add_field(entry, SymbolField, currency.symbol);
+			this->add_field(entry, SymbolNativeField, currency.symbol_native);
+			entry++;
+		}
+
+		this->scores.assign(this->codes.size(), 0);
+		this->shared.assign(this->trigram_counts.size(), 0);
+		this->touched_fields.clear();
+		this->candidates.clear();
+	}
+
+	bool CurrencySearch::empty()
+	{
+		return this->codes.empty();
+	}
+
+	void CurrencySearch::add_field(uint16_t entry, Field field, const string& text)
+	{
+		string normalized = normalize_search_text(text);
+		if (normalized.empty())
+		{
+			return;
+		}
+		int weight = field_weights[field];
+
+		// Exact matches
+		uint16_t exact_score = (uint16_t)(field == CodeField ? EXACT_CODE_SCORE : EXACT_FIELD_SCORE + weight);
+		this->exact[normalized].push_back({ entry, exact_score });
+
+		// Prefixes of the whole text and of every later word
+		bool first_word = true;
+		for (size_t start = 0; start < normalized.size(); start = normalized.find(' ', start) + 1)
+		{
+			uint16_t score = (uint16_t)((first_word ? PREFIX_SCORE : WORD_PREFIX_SCORE) + weight);
+			this->insert_key(std::string_view(normalized).substr(start), { entry, score });
+			first_word = false;
+			if (normalized.find(' ', start) == string::npos)
+			{
+				break;
+			}
+		}
+
+		// Trigrams for misspelled queries
+		std::vector<uint32_t> field_trigrams {};
+		get_trigrams(normalized, field_trigrams);
+		uint32_t field_ref = (uint32_t)entry * FieldCount + field;
+		for (uint32_t trigram : field_trigrams)
+		{
+			this->trigrams[trigram].push_back(field_ref);
+		}
+		this->trigram_counts[field_ref] = (uint16_t)field_trigrams.size();
+	}
+
+	void CurrencySearch::insert_key(std::string_view key, Posting posting)
+	{
+		uint32_t node = 0;
+		for (size_t i = 0; i <= key.size(); i++)
+		{
+			// All keys of an entry get inserted before the next entry, so its posting can only be the last one
+			std::vector<Posting>& postings = this->trie[node].postings;
+			if (!postings.empty() && postings.back().entry == posting.entry)
+			{
+				postings.back().score = std::max(postings.back().score, posting.score);
+			}
+			else if (i > 0)
+			{
+				postings.push_back(posting);
+			}
+
+			if (i == key.size())
+			{
+				break;
+			}
+
+			auto& children = this->trie[node].children;
+			auto child = std::lower_bound(children.begin(), children.end(), key[i], [](const std::pair<char, uint32_t>& element, char value) {
+				return element.first < value;
+			});
+			if (child != children.end() && child->first == key[i])
+			{
+				node = child->second;
+				continue;
+			}
+			uint32_t created = (uint32_t)this->trie.size();
+			children.insert(child, { key[i], created });
+			// Careful: push_back may move the node children belongs to
+			this->trie.push_back(TrieNode());
+			node = created;
+		}
+	}
+
+	const CurrencySearch::TrieNode* CurrencySearch::find_node(std::string_view prefix)
+	{
+		uint32_t node = 0;
+		for (char c : prefix)
+		{
+			auto& children = this->trie[node].children;
+			auto child = std::lower_bound(children.begin(), children.end(), c, [](const std::pair<char, uint32_t>& element, char value) {
+				return element.first < value;
+			});
+			if (child == children.end() || child->first != c)
+			{
+				return nullptr;
+			}
+			node = child->second;
+		}
+		return &this->trie[node];
+	}
+
+	void CurrencySearch::add_candidate(uint16_t entry, int score)
+	{
+		if (this->scores[entry] == 0)
+		{
+			this->candidates.push_back(entry);
+		}
+		this->scores[entry] = std::max(this->scores[entry], score);
+	}
+
+	std::vector<SearchMatch> CurrencySearch::search(std::string_view query, size_t max_results)
+	{
+		std::vector<SearchMatch> matches {};
+		normalize_search_text(query, this->query_text);
+		if (this->query_text.empty() || this->codes.empty())
+		{
+			return matches;
+		}
+
+		auto exact_match = this->exact.find(this->query_text);
+		if (exact_match != this->exact.end())
+		{
+			for (auto& posting : exact_match->second)
+			{
+				this->add_candidate(posting.entry, (int)posting.score);
+			}
+		}
+
+		const TrieNode* node = this->find_node(this->query_text);
+		if (node != nullptr)
+		{
+			for (auto& posting : node->postings)
+			{
+				this->add_candidate(posting.entry, (int)posting.score);
+			}
+		}
+
+		if (this->query_text.size() >= FUZZY_MIN_QUERY_LENGTH)
+		{
+			get_trigrams(this->query_text, this->query_trigrams);
+			for (uint32_t trigram : this->query_trigrams)
+			{
+				auto fields = this->trigrams.find(trigram);
+				if (fields == this->trigrams.end())
+				{
+					continue;
+				}
+				for (uint32_t field_ref : fields->second)
+				{
+					if (this->shared[field_ref]++ == 0)
+					{
+						this->touched_fields.push_back(field_ref);
+					}
+				}
+			}
+			// Only the fields sharing a trigram get looked at
+			for (uint32_t field_ref : this->touched_fields)
+			{
+				double similarity = 2.0 * this->shared[field_ref] / (double)(this->query_trigrams.size() + this->trigram_counts[field_ref]);
+				this->shared[field_ref] = 0;
+				if (similarity < FUZZY_MIN_SIMILARITY)
+				{
+					continue;
+				}
+				uint16_t entry = (uint16_t)(field_ref / FieldCount);
+				this->add_candidate(entry, FUZZY_SCORE + (int)(FUZZY_RANGE * similarity) + field_weights[field_ref % FieldCount]);
+			}
+			this->touched_fields.clear();
+		}
+
+		// Entries are numbered in alphabetical order of their codes, so that order decides within the same score
+		std::sort(this->candidates.begin(), this->candidates.end(), [this](uint16_t a, uint16_t b) {
+			return this->scores[a] != this->scores[b] ? this->scores[a] > this->scores[b] : a < b;
+		});
+		size_t count = std::min(max_results, this->candidates.size());
+		matches.reserve(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			uint16_t entry = this->candidates[i];
+			matches.push_back({ this->codes[entry], this->scores[entry] });
+		}
+
+		for (uint16_t entry : this->candidates)
+		{
+			this->scores[entry] = 0;
+		}
+		this->candidates.clear();
+		return matches;
+	}
+
+	string CurrencySearch::resolve(std::string_view query)
+	{
+		std::vector<SearchMatch> matches = this->search(query, 2);
+		if (matches.empty() || (matches.size() > 1 && matches[0].score == matches[1].score))
+		{
+			return "";
+		}
+		return matches[0].code;
+	}
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <cstdint>
+
+#include "Currency.h"
+
+namespace CurrencyConverter
+{
+	using std::string;
+
+	struct SearchMatch {
+		string code;
+		// Higher is better. See CurrencySearch::search() for the ranking.
+		int score;
+	};
+
+	// Finds currencies by code, name, plural name or symbol instead of the exact code only.
+	// Built once from the currency list. Queries only score the currencies the exact map, the trie and the trigram index
+	// return for them and reuse the scratch buffers of the index, so they are not thread safe.
+	//
+	//     search.search("swiss fr")  -> CHF (prefix of "Swiss Franc")
+	//     search.search("yen")       -> JPY (prefix of a later word of "Japanese Yen")
+	//     search.search("swis frank") -> CHF (typo, found through shared trigrams)
+	//
+	// Case and repeated spaces don't matter. Symbols like "$" or "¥" match as they are.
+	class CurrencySearch {
+	public:
+		CurrencySearch();
+		~CurrencySearch();
+
+		// Replaces the index with one for the given currency list
+		void build(const std::map<string, Currency>& currencies);
+		bool empty();
+
+		// Ranked best first.
+		// Exact code > exact name or symbol > prefix of a name > prefix of a later word > similar spelling.
+		// Within each kind code beats name beats plural name beats symbol.
+		std::vector<SearchMatch> search(std::string_view query, size_t max_results = 5);
+
+		// Code of the single best match. Empty if nothing matches or the two best matches are ranked the same.
+		string resolve(std::string_view query);
+
+	private:
+		enum Field : uint8_t { CodeField, NameField, NamePluralField, SymbolField, SymbolNativeField, FieldCount };
+
+		struct Posting {
+			uint16_t entry;
+			uint16_t score;
+		};
+
+		// Trie node. Children are sorted by byte so that lookups can use a binary search.
+		// Every node keeps the best score of each entry with a key below it, so a prefix query is a walk down plus a copy.
+		struct TrieNode {
+			std::vector<std::pair<char, uint32_t>> children;
+			std::vector<Posting> postings;
+		};
+
+		std::vector<string> codes;
+		std::vector<TrieNode> trie;
+		// Normalized full field text (key) -> entries where a field is exactly that text
+		std::unordered_map<string, std::vector<Posting>> exact;
+		// Packed trigram (key) -> entry * FieldCount + field of every field containing it
+		std::unordered_map<uint32_t, std::vector<uint32_t>> trigrams;
+		// Number of trigrams per entry * FieldCount + field
+		std::vector<uint16_t> trigram_counts;
+
+		// Scratch buffers of search(), sized by build(). Scores and shared trigram counts are reset after every query.
+		string query_text;
+		std::vector<uint32_t> query_trigrams;
+		// Per entry
+		std::vector<int> scores;
+		// Per entry * FieldCount + field
+		std::vector<uint16_t> shared;
+		// Fields sharing at least one trigram with the query
+		std::vector<uint32_t> touched_fields;
+		// Entries with a score above 0
+		std::vector<uint16_t> candidates;
+
+		void add_field(uint16_t entry, Field field, const string& text);
+		void add_candidate(uint16_t entry, int score);
+		void insert_key(std::string_view key, Posting posting);
+		const TrieNode* find_node(std::string_view prefix);
+	};
+
+	// Lower case, single spaces, no leading or trailing spaces. Non ascii bytes are kept as they are.
+	string normalize_search_text(std::string_view text);
+	// Same into an existing string, which keeps its capacity
+	void normalize_search_text(std::string_view text, string& normalized);
+}
@@ -0,0 +1,109 @@
+#include "FetchValidators.h"
+#include <sstream>
+#include <cstring>
+
+#include "RateTable.h"
+
+namespace CurrencyConverter
+{
+	// Header names are case insensitive
+	static bool starts_with_ignoring_case(const string& text, const string& prefix)
+	{
+		if (text.size() < prefix.size())
+		{
+			return false;
+		}
+		for (size_t i = 0; i < prefix.size(); i++)
+		{
+			if (tolower((unsigned char)text[i]) != tolower((unsigned char)prefix[i]))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	static string trim(const string& text)
+	{
+		size_t begin = text.find_first_not_of(" \t\r\n");
+		if (begin == string::npos)
+		{
+			return "";
+		}
+		size_t end = text.find_last_not_of(" \t\r\n");
+		return text.substr(begin, end - begin + 1);
+	}
+
+	void add_conditional_headers(std::list<string>& headers, const FetchValidators& validators)
+	{
+		if (!validators.etag.empty())
+		{
+			headers.push_back("If-None-Match: " + validators.etag);
+		}
+		if (!validators.last_modified.empty())
+		{
+			headers.push_back("If-Modified-Since: " + validators.last_modified);
+		}
+	}
+
+	void read_validators(const string& response_headers, FetchValidators& validators)
+	{
+		string etag = "";
+		string last_modified = "";
+
+		std::istringstream lines(response_headers);
+		string line = "";
+		while (getline(lines, line))
+		{
+			// Redirects produce several header blocks. Only the last one belongs to the actual response.
+			if (starts_with_ignoring_case(line, "HTTP/"))
+			{
+				etag = "";
+				last_modified = "";
+			}
+			else if (starts_with_ignoring_case(line, "ETag:"))
+			{
+				etag = trim(line.substr(strlen("ETag:")));
+			}
+			else if (starts_with_ignoring_case(line, "Last-Modified:"))
+			{
+				last_modified = trim(line.substr(strlen("Last-Modified:")));
+			}
+		}
+
+		validators.etag = etag;
+		validators.last_modified = last_modified;
+	}
+
+	string find_last_updated_at(const string& response_body)
+	{
+		// Example: {"meta":{"last_updated_at":"2022-01-01T23:59:59Z"},"data":{...}}
+		const string key = "\"last_updated_at\"";
+		size_t position = response_body.find(key);
+		if (position == string::npos)
+		{
+			return "";
+		}
+		size_t begin = response_body.find('"', response_body.find(':', position + key.size()));
+		if (begin == string::npos)
+		{
+			return "";
+		}
+		size_t end = response_body.find('"', begin + 1);
+		if (end == string::npos)
+		{
+			return "";
+		}
+		return response_body.substr(begin + 1, end - begin - 1);
+	}
+
+	bool exchange_rates_may_have_changed(const FetchValidators& validators, int64_t now, int64_t update_interval)
+	{
+		int64_t last_updated_at = parse_api_timestamp(validators.last_updated_at);
+		if (last_updated_at == 0)
+		{
+			return true;
+		}
+		return now >= last_updated_at + update_interval;
+	}
+}
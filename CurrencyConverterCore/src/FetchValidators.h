@@ -0,0 +1,39 @@
+#pragma once
+#include <string>
+#include <list>
+#include <cstdint>
+
+namespace CurrencyConverter
+{
+	using std::string;
+
+	// Keys of AppState::fetch_validators
+	constexpr const char* CURRENCIES_VALIDATORS_KEY = "currencies";
+	// Followed by the code of the base currency, e.g. "latest/EUR"
+	constexpr const char* EXCHANGE_RATES_VALIDATORS_KEY = "latest/";
+
+	// What is known about the last successful response of an endpoint.
+	// Used to ask the server for changes only and to skip requests for data that can't have changed yet.
+	struct FetchValidators {
+		// ETag and Last-Modified response headers. Empty if the server didn't send them.
+		string etag;
+		string last_modified;
+		// meta.last_updated_at of the latest endpoint
+		string last_updated_at;
+	};
+
+	// Adds If-None-Match / If-Modified-Since for the stored validators.
+	// The server answers with 304 and an empty body if nothing changed.
+	void add_conditional_headers(std::list<string>& headers, const FetchValidators& validators);
+
+	// Takes ETag and Last-Modified from the raw response headers into validators.
+	void read_validators(const string& response_headers, FetchValidators& validators);
+
+	// Reads meta.last_updated_at straight from the response body without parsing the whole json.
+	// Returns an empty string if it isn't there.
+	string find_last_updated_at(const string& response_body);
+
+	// Upstream publishes new rates once per update_interval (a day for freecurrencyapi.com).
+	// Returns false while the last fetched rates are younger than that, so the request can be skipped completely.
+	bool exchange_rates_may_have_changed(const FetchValidators& validators, int64_t now, int64_t update_interval);
+}
@@ -0,0 +1,168 @@
+#include "LatencyHistogram.h"
+#include <bit>
+#include <cstring>
+#include <iomanip>
+
+namespace CurrencyConverter
+{
+	LatencyHistogram::LatencyHistogram()
+	{
+		this->clear();
+	}
+
+	LatencyHistogram::~LatencyHistogram()
+	{
+	}
+
+	// Values below SUB_BUCKETS get a bucket each.
+	// Above that every power of two is split into SUB_BUCKETS buckets of equal width.
+	size_t LatencyHistogram::bucket_of(uint64_t value)
+	{
+		if (value < SUB_BUCKETS)
+		{
+			return (size_t)value;
+		}
+		size_t highest_bit = (size_t)std::bit_width(value) - 1;
+		size_t sub_bucket = (size_t)(value >> (highest_bit - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+		return (highest_bit - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + sub_bucket;
+	}
+
+	uint64_t LatencyHistogram::bucket_upper_bound(size_t bucket)
+	{
+		if (bucket < SUB_BUCKETS)
+		{
+			return (uint64_t)bucket;
+		}
+		size_t highest_bit = bucket / SUB_BUCKETS + SUB_BUCKET_BITS - 1;
+		uint64_t sub_bucket = bucket % SUB_BUCKETS;
+		uint64_t lower = (SUB_BUCKETS + sub_bucket) << (highest_bit - SUB_BUCKET_BITS);
+		return lower + (1ull << (highest_bit - SUB_BUCKET_BITS)) - 1;
+	}
+
+	void LatencyHistogram::record(uint64_t nanoseconds)
+	{
+		this->buckets[bucket_of(nanoseconds)]++;
+		this->total_count++;
+		this->total_sum += nanoseconds;
+		if (nanoseconds < this->min_value)
+		{
+			this->min_value = nanoseconds;
+		}
+		if (nanoseconds > this->max_value)
+		{
+			this->max_value = nanoseconds;
+		}
+	}
+
+	void LatencyHistogram::merge(const LatencyHistogram& other)
+	{
+		for (size_t i = 0; i < BUCKET_COUNT; i++)
+		{
+			this->buckets[i] += other.buckets[i];
+		}
+		this->total_count += other.total_count;
+		this->total_sum += other.total_sum;
+		if (other.min_value < this->min_value)
+		{
+			this->min_value = other.min_value;
+		}
+		if (other.max_value > this->max_value)
+		{
+			this->max_value = other.max_value;
+		}
+	}
+
+	void LatencyHistogram::clear()
+	{
+		memset(this->buckets, 0, sizeof(this->buckets));
+		this->total_count = 0;
+		this->total_sum = 0;
+		this->min_value = UINT64_MAX;
+		this->max_value = 0;
+	}
+
+	uint64_t LatencyHistogram::count() const
+	{
+		return this->total_count;
+	}
+
+	uint64_t LatencyHistogram::min() const
+	{
+		return this->total_count == 0 ? 0 : this->min_value;
+	}
+
+	uint64_t LatencyHistogram::max() const
+	{
+		return this->max_value;
+	}
+
+	double LatencyHistogram::mean() const
+	{
+		return this->total_count == 0 ? 0.0 : (double)this->total_sum / (double)this->total_count;
+	}
+
+	uint64_t LatencyHistogram::percentile(double percent) const
+	{
+		if (this->total_count == 0)
+		{
+			return 0;
+		}
+		// Rank of the value that has percent of all values at or below it
+		uint64_t rank = (uint64_t)(percent / 100.0 * (double)this->total_count + 0.5);
+		if (rank < 1)
+		{
+			rank = 1;
+		}
+		uint64_t seen = 0;
+		for (size_t i = 0; i < BUCKET_COUNT; i++)
+		{
+			seen += this->buckets[i];
+			if (seen >= rank)
+			{
+				// Never report more than was actually recorded
+				uint64_t bound = bucket_upper_bound(i);
+				return bound < this->max_value ? bound : this->max_value;
+			}
+		}
+		return this->max_value;
+	}
+
+	void LatencyHistogram::write_summary(std::ostream& stream) const
+	{
+		stream << "n=" << this->total_count << " mean=";
+		write_duration(stream, (uint64_t)this->mean());
+		stream << " p50=";
+		write_duration(stream, this->percentile(50.0));
+		stream << " p99=";
+		write_duration(stream, this->percentile(99.0));
+		stream << " p99.9=";
+		write_duration(stream, this->percentile(99.9));
+		stream << " max=";
+		write_duration(stream, this->max());
+	}
+
+	void write_duration(std::ostream& stream, uint64_t nanoseconds)
+	{
+		std::ios_base::fmtflags flags = stream.flags();
+		std::streamsize precision = stream.precision();
+		stream << std::fixed << std::setprecision(1);
+		if (nanoseconds < 1000)
+		{
+			stream << nanoseconds << "ns";
+		}
+		else if (nanoseconds < 1000 * 1000)
+		{
+			stream << (double)nanoseconds / 1e3 << "us";
+		}
+		else if (nanoseconds < 1000 * 1000 * 1000)
+		{
+			stream << (double)nanoseconds / 1e6 << "ms";
+		}
+		else
+		{
+			stream << (double)nanoseconds / 1e9 << "s";
+		}
+		stream.flags(flags);
+		stream.precision(precision);
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <ostream>
+
+namespace CurrencyConverter
+{
+	// Counts durations in nanoseconds with a fixed amount of memory.
+	// Buckets grow exponentially with 32 sub buckets each, so every value is stored with an error below 3.2%.
+	// Recording is a few instructions and never allocates, so it can be done on hot paths of benchmarks.
+	class LatencyHistogram {
+	public:
+		LatencyHistogram();
+		~LatencyHistogram();
+
+		void record(uint64_t nanoseconds);
+		// Adds all values of another histogram, e.g. to combine the histograms of several threads
+		void merge(const LatencyHistogram& other);
+		void clear();
+
+		uint64_t count() const;
+		uint64_t min() const;
+		uint64_t max() const;
+		double mean() const;
+		// Upper bound of the bucket holding the given percentile (0 - 100)
+		uint64_t percentile(double percent) const;
+
+		// One line like "n=1000 mean=12ns p50=11ns p99=40ns p99.9=95ns max=1.2us"
+		void write_summary(std::ostream& stream) const;
+
+	private:
+		static constexpr size_t SUB_BUCKET_BITS = 5;
+		static constexpr size_t SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+		static constexpr size_t BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+		uint64_t buckets[BUCKET_COUNT];
+		uint64_t total_count;
+		uint64_t total_sum;
+		uint64_t min_value;
+		uint64_t max_value;
+
+		static size_t bucket_of(uint64_t value);
+		static uint64_t bucket_upper_bound(size_t bucket);
+	};
+
+	// Writes a duration with a fitting unit, e.g. "850ns", "12.4us" or "3.1ms"
+	void write_duration(std::ostream& stream, uint64_t nanoseconds);
+}
@@ -0,0 +1,219 @@
+#include "MoneyCodec.h"
+#include <charconv>
+#include <cstring>
+#include <cmath>
+
+namespace CurrencyConverter
+{
+	static bool is_digit(char character)
+	{
+		return character >= '0' && character <= '9';
+	}
+
+	static bool is_space(char character)
+	{
+		return character == ' ' || character == '\t' || character == '\r' || character == '\n';
+	}
+
+	static bool is_ascii_letter(char character)
+	{
+		return (character >= 'a' && character <= 'z') || (character >= 'A' && character <= 'Z');
+	}
+
+	MoneyFormat make_money_format(const string& symbol, uint8_t decimal_digits, char decimal_separator, char grouping_separator)
+	{
+		MoneyFormat format {};
+
+		// Leave room for the separating space
+		size_t length = symbol.size();
+		if (length > MONEY_FORMAT_MAX_AFFIX - 1)
+		{
+			length = MONEY_FORMAT_MAX_AFFIX - 1;
+		}
+		memcpy(format.prefix, symbol.data(), length);
+
+		// "CHF 12.50" reads better than "CHF12.50" while "$12.50" is the usual way to write symbols
+		if (length > 0 && is_ascii_letter(symbol[length - 1]))
+		{
+			format.prefix[length] = ' ';
+			length++;
+		}
+		format.prefix_length = (uint8_t)length;
+
+		format.decimal_digits = decimal_digits;
+		format.decimal_separator = decimal_separator;
+		format.grouping_separator = grouping_separator;
+		return format;
+	}
+
+	ParseAmountResult parse_amount(std::string_view text, double& amount, char decimal_separator, char grouping_separator)
+	{
+		// Ignore surrounding whitespace
+		size_t begin = 0;
+		size_t end = text.size();
+		while (begin < end && is_space(text[begin]))
+		{
+			begin++;
+		}
+		while (end > begin && is_space(text[end - 1]))
+		{
+			end--;
+		}
+		if (begin == end)
+		{
+			return ParseAmountResult::Empty;
+		}
+
+		// from_chars only understands "-123.45" so the input gets normalized into this buffer first.
+		// 128 characters are far more than a double can hold in significant digits anyway.
+		char normalized[128];
+		size_t length = 0;
+		size_t digit_count = 0;
+		bool seen_decimal_separator = false;
+		// Digits since the last grouping separator (or the start) and whether there was one
+		size_t group_digit_count = 0;
+		bool seen_grouping_separator = false;
+
+		size_t position = begin;
+		if (text[position] == '+' || text[position] == '-')
+		{
+			if (text[position] == '-')
+			{
+				normalized[length++] = '-';
+			}
+			position++;
+		}
+
+		for (; position < end; position++)
+		{
+			char character = text[position];
+			if (length >= sizeof(normalized))
+			{
+				return ParseAmountResult::Invalid;
+			}
+
+			if (is_digit(character))
+			{
+				normalized[length++] = character;
+				digit_count++;
+				group_digit_count++;
+			}
+			else if (character == decimal_separator && !seen_decimal_separator)
+			{
+				// The last group has to be complete as well
+				if (seen_grouping_separator && group_digit_count != 3)
+				{
+					return ParseAmountResult::Invalid;
+				}
+				normalized[length++] = '.';
+				seen_decimal_separator = true;
+			}
+			else if (grouping_separator != 0 && character == grouping_separator && !seen_decimal_separator)
+			{
+				// "1,234,567": the first group has 1 to 3 digits, every later one exactly 3
+				bool valid_group = seen_grouping_separator ? group_digit_count == 3 : group_digit_count >= 1 && group_digit_count <= 3;
+				if (!valid_group)
+				{
+					return ParseAmountResult::Invalid;
+				}
+				// Grouping separators carry no information
+				seen_grouping_separator = true;
+				group_digit_count = 0;
+			}
+			else
+			{
+				return ParseAmountResult::Invalid;
+			}
+		}
+
+		if (digit_count == 0 || (seen_grouping_separator && !seen_decimal_separator && group_digit_count != 3))
+		{
+			return ParseAmountResult::Invalid;
+		}
+
+		double value = 0.0;
+		auto result = std::from_chars(normalized, normalized + length, value, std::chars_format::fixed);
+		if (result.ec == std::errc::result_out_of_range)
+		{
+			return ParseAmountResult::OutOfRange;
+		}
+		if (result.ec != std::errc() || result.ptr != normalized + length)
+		{
+			return ParseAmountResult::Invalid;
+		}
+
+		amount = value;
+		return ParseAmountResult::Ok;
+	}
+
+	size_t format_money(char* buffer, size_t buffer_size, double amount, const MoneyFormat& format)
+	{
+		if (!std::isfinite(amount))
+		{
+			return 0;
+		}
+
+		// Digits of the absolute value rounded to the decimal digits of the currency. DBL_MAX has 309 integer digits.
+		char digits[400];
+		bool negative = amount < 0.0;
+		double magnitude = negative ? -amount : amount;
+		auto result = std::to_chars(digits, digits + sizeof(digits), magnitude, std::chars_format::fixed, (int)format.decimal_digits);
+		if (result.ec != std::errc())
+		{
+			return 0;
+		}
+		size_t digits_length = (size_t)(result.ptr - digits);
+		size_t integer_length = format.decimal_digits > 0 ? digits_length - format.decimal_digits - 1 : digits_length;
+
+		// Don't write "-$0.00" for tiny negative amounts that got rounded to zero
+		if (negative)
+		{
+			negative = false;
+			for (size_t i = 0; i < digits_length; i++)
+			{
+				if (digits[i] >= '1' && digits[i] <= '9')
+				{
+					negative = true;
+					break;
+				}
+			}
+		}
+
+		size_t group_count = format.grouping_separator != 0 ? (integer_length - 1) / 3 : 0;
+		size_t total_length = (negative ? 1 : 0) + format.prefix_length + integer_length + group_count;
+		if (format.decimal_digits > 0)
+		{
+			total_length += 1 + format.decimal_digits;
+		}
+		if (total_length > buffer_size)
+		{
+			return 0;
+		}
+
+		char* output = buffer;
+		if (negative)
+		{
+			*output++ = '-';
+		}
+		memcpy(output, format.prefix, format.prefix_length);
+		output += format.prefix_length;
+
+		for (size_t i = 0; i < integer_length; i++)
+		{
+			if (i > 0 && format.grouping_separator != 0 && (integer_length - i) % 3 == 0)
+			{
+				*output++ = format.grouping_separator;
+			}
+			*output++ = digits[i];
+		}
+
+		if (format.decimal_digits > 0)
+		{
+			*output++ = format.decimal_separator;
+			memcpy(output, digits + integer_length + 1, format.decimal_digits);
+			output += format.decimal_digits;
+		}
+
+		return (size_t)(output - buffer);
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+
+namespace CurrencyConverter
+{
+	using std::string;
+
+	// Longest currency symbol of the api is 5 bytes of utf-8 (e.g. "د.إ"), so there is plenty of room here.
+	constexpr size_t MONEY_FORMAT_MAX_AFFIX = 24;
+
+	// Formatting template of a currency. Built once from the currency metadata and then reused for every amount.
+	struct MoneyFormat {
+		// Written in front of the amount, e.g. "$" or "CHF "
+		char prefix[MONEY_FORMAT_MAX_AFFIX];
+		uint8_t prefix_length;
+		// Number of digits after the decimal separator
+		uint8_t decimal_digits;
+		char decimal_separator;
+		// 0 disables grouping
+		char grouping_separator;
+	};
+
+	enum class ParseAmountResult {
+		Ok,
+		Empty,
+		Invalid,
+		OutOfRange
+	};
+
+	// Builds the template for a currency symbol. Symbols ending in a letter get a space between symbol and amount.
+	MoneyFormat make_money_format(const string& symbol, uint8_t decimal_digits, char decimal_separator = '.', char grouping_separator = ',');
+
+	// Parses amounts like "1234.5", "1,234.50", " -12 " or with swapped separators "1.234,50".
+	// Grouping separators are only accepted in the integer part, as groups of exactly 3 digits after a first group of 1 to 3 digits.
+	// "1,5" or "1,00.5" are invalid instead of being read as 15 and 100.5.
+	// Unlike atof() invalid input is reported instead of being read as 0.
+	// Doesn't allocate.
+	ParseAmountResult parse_amount(std::string_view text, double& amount, char decimal_separator = '.', char grouping_separator = ',');
+
+	// Writes the formatted amount into buffer, e.g. "$1,234.50".
+	// Returns the number of characters written or 0 if the buffer was too small.
+	// Doesn't allocate and doesn't terminate the text with a zero.
+	size_t format_money(char* buffer, size_t buffer_size, double amount, const MoneyFormat& format);
+}
@@ -0,0 +1,272 @@
+#include "RateAnalytics.h"
+#include <cmath>
+#include <algorithm>
+#include <tuple>
+
+namespace CurrencyConverter
+{
+	PairSeries::PairSeries(size_t window_count)
+	{
+		this->first_number = 0;
+		this->windows.resize(window_count);
+		for (auto& window : this->windows)
+		{
+			window.first = 0;
+			window.area = 0.0;
+			window.return_sum = 0.0;
+			window.return_square_sum = 0.0;
+			window.return_count = 0;
+		}
+	}
+
+	PairSeries::~PairSeries()
+	{
+	}
+
+	PairSeries::Sample& PairSeries::sample(uint64_t number)
+	{
+		return this->samples[(size_t)(number - this->first_number)];
+	}
+
+	void PairSeries::add(int64_t at, double rate, const std::vector<int64_t>& window_seconds)
+	{
+		if (!this->samples.empty() && at <= this->samples.back().at)
+		{
+			return;
+		}
+
+		uint64_t number = this->first_number + this->samples.size();
+		Sample added { at, rate, 0.0 };
+		double area = 0.0;
+		if (!this->samples.empty())
+		{
+			Sample& previous = this->samples.back();
+			// The previous rate was in effect until now
+			area = previous.rate * (double)(at - previous.at);
+			if (previous.rate > 0.0 && rate > 0.0)
+			{
+				added.log_return = std::log(rate / previous.rate);
+			}
+		}
+		this->samples.push_back(added);
+
+		uint64_t oldest_needed = number;
+		for (size_t i = 0; i < this->windows.size(); i++)
+		{
+			Window& window = this->windows[i];
+			if (number > 0)
+			{
+				window.area += area;
+				window.return_sum += added.log_return;
+				window.return_square_sum += added.log_return * added.log_return;
+				window.return_count++;
+			}
+			while (!window.minimums.empty() && this->sample(window.minimums.back()).rate >= rate)
+			{
+				window.minimums.pop_back();
+			}
+			window.minimums.push_back(number);
+			while (!window.maximums.empty() && this->sample(window.maximums.back()).rate <= rate)
+			{
+				window.maximums.pop_back();
+			}
+			window.maximums.push_back(number);
+
+			this->advance(window, window_seconds[i], at);
+			oldest_needed = std::min(oldest_needed, window.first);
+		}
+
+		// Nothing needs the samples before the start of the longest window anymore
+		while (this->first_number < oldest_needed)
+		{
+			this->samples.pop_front();
+			this->first_number++;
+		}
+	}
+
+	void PairSeries::advance(Window& window, int64_t window_seconds, int64_t now)
+	{
+		int64_t start = now - window_seconds;
+		uint64_t end = this->first_number + this->samples.size();
+		// The first sample stays as long as it was still in effect at the start of the window
+		while (window.first + 1 < end && this->sample(window.first + 1).at <= start)
+		{
+			Sample& dropped = this->sample(window.first);
+			Sample& next = this->sample(window.first + 1);
+			window.area -= dropped.rate * (double)(next.at - dropped.at);
+			// The return of the next sample was made from the dropped one
+			window.return_sum -= next.log_return;
+			window.return_square_sum -= next.log_return * next.log_return;
+			window.return_count--;
+			window.first++;
+		}
+		while (window.minimums.front() < window.first)
+		{
+			window.minimums.pop_front();
+		}
+		while (window.maximums.front() < window.first)
+		{
+			window.maximums.pop_front();
+		}
+	}
+
+	bool PairSeries::get_statistics(size_t window_index, int64_t window_seconds, int64_t now, RateStatistics& statistics)
+	{
+		if (this->samples.empty())
+		{
+			return false;
+		}
+		Window& window = this->windows[window_index];
+		Sample& latest = this->samples.back();
+		now = std::max(now, latest.at);
+		this->advance(window, window_seconds, now);
+
+		Sample& first = this->sample(window.first);
+		int64_t start = now - window_seconds;
+		int64_t covered_from = std::max(start, first.at);
+		// The running area ends at the latest sample and starts at the first one.
+		// Add the latest rate until now and remove the part of the first one before the window.
+		double area = window.area + latest.rate * (double)(now - latest.at) - first.rate * (double)std::max<int64_t>(0, start - first.at);
+
+		statistics.spot = latest.rate;
+		statistics.covered_seconds = now - covered_from;
+		statistics.twap = statistics.covered_seconds > 0 ? area / (double)statistics.covered_seconds : latest.rate;
+		statistics.min = this->sample(window.minimums.front()).rate;
+		statistics.max = this->sample(window.maximums.front()).rate;
+		statistics.samples = this->first_number + this->samples.size() - window.first;
+		statistics.volatility = 0.0;
+		if (window.return_count >= 2)
+		{
+			double count = (double)window.return_count;
+			double variance = (window.return_square_sum - window.return_sum * window.return_sum / count) / (count - 1.0);
+			// Running sums can end up slightly below 0 through rounding
+			statistics.volatility = variance > 0.0 ? std::sqrt(variance) : 0.0;
+		}
+		return true;
+	}
+
+	RateAnalytics::RateAnalytics()
+	{
+		this->windows = DEFAULT_ANALYTICS_WINDOWS;
+		this->pairs = 0;
+	}
+
+	RateAnalytics::~RateAnalytics()
+	{
+	}
+
+	void RateAnalytics::set_windows(const std::vector<int64_t>& window_seconds)
+	{
+		this->windows = window_seconds;
+		this->series.clear();
+		this->pairs = 0;
+	}
+
+	const std::vector<int64_t>& RateAnalytics::get_windows()
+	{
+		return this->windows;
+	}
+
+	void RateAnalytics::update(const string& base_code, const std::map<string, float>& exchange_rates, int64_t last_updated_at)
+	{
+		std::map<string, PairSeries>& row = this->series[base_code];
+		// Both maps are sorted by code, so one pass over both finds (or inserts) every pair
+		auto position = row.begin();
+		for (auto& entry : exchange_rates)
+		{
+			while (position != row.end() && position->first < entry.first)
+			{
+				position++;
+			}
+			if (position == row.end() || position->first != entry.first)
+			{
+				position = row.emplace_hint(position, std::piecewise_construct, std::forward_as_tuple(entry.first), std::forward_as_tuple(this->windows.size()));
+				this->pairs++;
+			}
+			position->second.add(last_updated_at, entry.second, this->windows);
+		}
+	}
+
+	bool RateAnalytics::get_statistics(const string& base_code, const string& target_code, int64_t window_seconds, int64_t now, RateStatistics& statistics)
+	{
+		auto window = std::find(this->windows.begin(), this->windows.end(), window_seconds);
+		if (window == this->windows.end())
+		{
+			return false;
+		}
+		auto row = this->series.find(base_code);
+		if (row == this->series.end())
+		{
+			return false;
+		}
+		auto pair = row->second.find(target_code);
+		if (pair == row->second.end())
+		{
+			return false;
+		}
+		return pair->second.get_statistics((size_t)(window - this->windows.begin()), window_seconds, now, statistics);
+	}
+
+	size_t RateAnalytics::pair_count()
+	{
+		return this->pairs;
+	}
+
+	bool parse_window(const string& text, int64_t& seconds)
+	{
+		if (text.size() < 2)
+		{
+			return false;
+		}
+		int64_t unit = 0;
+		switch (text.back())
+		{
+			case 's':
+				unit = 1;
+				break;
+			case 'm':
+				unit = 60;
+				break;
+			case 'h':
+				unit = 60 * 60;
+				break;
+			case 'd':
+				unit = 24 * 60 * 60;
+				break;
+			default:
+				return false;
+		}
+		int64_t count = 0;
+		for (size_t i = 0; i + 1 < text.size(); i++)
+		{
+			if (text[i] < '0' || text[i] > '9' || count > 1000000)
+			{
+				return false;
+			}
+			count = count * 10 + (text[i] - '0');
+		}
+		if (count == 0)
+		{
+			return false;
+		}
+		seconds = count * unit;
+		return true;
+	}
+
+	string format_window(int64_t seconds)
+	{
+		if (seconds % (24 * 60 * 60) == 0)
+		{
+			return std::to_string(seconds / (24 * 60 * 60)) + "d";
+		}
+		if (seconds % (60 * 60) == 0)
+		{
+			return std::to_string(seconds / (60 * 60)) + "h";
+		}
+		if (seconds % 60 == 0)
+		{
+			return std::to_string(seconds / 60) + "m";
+		}
+		return std::to_string(seconds) + "s";
+	}
+}
@@ -0,0 +1,109 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <cstdint>
+
+namespace CurrencyConverter
+{
+	using std::string;
+
+	// Windows every pair gets statistics for unless configured otherwise: 1 hour, 1 day, 30 days
+	inline const std::vector<int64_t> DEFAULT_ANALYTICS_WINDOWS = { 60 * 60, 24 * 60 * 60, 30 * 24 * 60 * 60 };
+
+	// Statistics of one pair over one window, as of the time they were asked for
+	struct RateStatistics {
+		// Latest rate
+		double spot;
+		// Time weighted average. Every rate counts for as long as it was the latest one.
+		double twap;
+		double min;
+		double max;
+		// Standard deviation of the log returns between consecutive updates in the window. 0 with less than 2 returns.
+		double volatility;
+		// Updates that were in effect during the window
+		uint64_t samples;
+		// Part of the window there are rates for. Shorter than the window while the history is young.
+		int64_t covered_seconds;
+	};
+
+	// Rate history of one pair with running statistics for every window.
+	// Every window keeps the sum of rate * duration (for the twap), the sums of the returns and their squares (for the volatility)
+	// and two monotonic deques of sample numbers (for min and max). Adding a sample and moving a window forward
+	// only touch the ends of these, so both are O(1) amortized no matter how long the window is.
+	// Samples are kept for as long as the longest window needs them.
+	class PairSeries {
+	public:
+		PairSeries(size_t window_count);
+		~PairSeries();
+
+		// Samples that aren't newer than the latest one are ignored (e.g. the same rates published again)
+		void add(int64_t at, double rate, const std::vector<int64_t>& window_seconds);
+		// Returns false if there is no sample yet
+		bool get_statistics(size_t window, int64_t window_seconds, int64_t now, RateStatistics& statistics);
+
+	private:
+		struct Sample {
+			int64_t at;
+			double rate;
+			// Log return since the previous sample
+			double log_return;
+		};
+
+		struct Window {
+			// Number of the oldest sample that was in effect during the window
+			uint64_t first;
+			// Sum of rate * seconds of every sample from first until the latest one
+			double area;
+			// Of the returns of the samples after first
+			double return_sum;
+			double return_square_sum;
+			uint64_t return_count;
+			// Sample numbers with increasing (minimums) and decreasing (maximums) rates. The front is the min / max of the window.
+			std::deque<uint64_t> minimums;
+			std::deque<uint64_t> maximums;
+		};
+
+		std::deque<Sample> samples;
+		// Number of samples.front()
+		uint64_t first_number;
+		std::vector<Window> windows;
+
+		Sample& sample(uint64_t number);
+		// Drops the samples that ended before the window started
+		void advance(Window& window, int64_t window_seconds, int64_t now);
+	};
+
+	// Streaming statistics of every pair the rate table publishes: time weighted average, min, max and volatility per window.
+	// Subscribed to RateTable::update_row(), so it sees every fetched (or synthetic) row as it comes in.
+	// The pair source -> target is the rate of target in the row of source, like convert_money() uses it.
+	// Not thread safe. Updates and queries happen on the thread that writes the rate table.
+	class RateAnalytics {
+	public:
+		RateAnalytics();
+		~RateAnalytics();
+
+		// Replaces the windows. Forgets the history so far.
+		void set_windows(const std::vector<int64_t>& window_seconds);
+		const std::vector<int64_t>& get_windows();
+
+		void update(const string& base_code, const std::map<string, float>& exchange_rates, int64_t last_updated_at);
+
+		// Returns false if window_seconds isn't one of the windows or the pair has no rates yet
+		bool get_statistics(const string& base_code, const string& target_code, int64_t window_seconds, int64_t now, RateStatistics& statistics);
+
+		size_t pair_count();
+
+	private:
+		std::vector<int64_t> windows;
+		// Key: base code, then target code
+		std::map<string, std::map<string, PairSeries>> series;
+		size_t pairs;
+	};
+
+	// "90s", "15m", "1h", "24h", "1d", "30d". Returns false for anything else.
+	bool parse_window(const string& text, int64_t& seconds);
+	// Shortest of the forms above, e.g. 86400 -> "1d"
+	string format_window(int64_t seconds);
+}
@@ -0,0 +1,375 @@
+#include "RateTable.h"
+#include <cstring>
+#include <ctime>
+#include <sstream>
+#include <iomanip>
+#include <new>
+#include <iostream>
+
+namespace CurrencyConverter
+{
+	// ---------- Seqlock helpers ----------
+
+	// Marks the start of a write. Makes the sequence number odd.
+	static void begin_write(std::atomic<uint64_t>& sequence)
+	{
+		sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+	}
+
+	// Marks the end of a write. Makes the sequence number even again and publishes the written data.
+	static void end_write(std::atomic<uint64_t>& sequence)
+	{
+		sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+	// Calls read until it ran without a concurrent write.
+	// read has to be side effect free apart from writing into its own output variables since it may run multiple times.
+	// Returns false if that didn't happen within RATE_TABLE_READ_ATTEMPTS, e.g. because the publisher died in the middle of a write.
+	template <typename Read>
+	static bool seqlock_read(const std::atomic<uint64_t>& sequence, Read read)
+	{
+		for (uint32_t attempt = 0; attempt < RATE_TABLE_READ_ATTEMPTS; attempt++)
+		{
+			uint64_t before = sequence.load(std::memory_order_acquire);
+			if ((before & 1) == 0)
+			{
+				read();
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if (sequence.load(std::memory_order_relaxed) == before)
+				{
+					return true;
+				}
+			}
+			// Writer is busy. Tell the cpu that this is a spin loop.
+			YieldProcessor();
+		}
+		return false;
+	}
+
+	// Index lookup without synchronisation. Only for the writer or from inside a seqlock_read.
+	static int find_index(const RateTableLayout* layout, const char* code)
+	{
+		uint32_t count = layout->currency_count;
+		if (count > RATE_TABLE_MAX_CURRENCIES)
+		{
+			return -1;
+		}
+		for (uint32_t i = 0; i < count; i++)
+		{
+			if (strncmp(layout->codes[i], code, RATE_TABLE_CODE_SIZE) == 0)
+			{
+				return (int)i;
+			}
+		}
+		return -1;
+	}
+
+	// ---------- Readers ----------
+
+	int rate_table_index_of(const RateTableLayout* layout, const char* code)
+	{
+		int index = -1;
+		if (!seqlock_read(layout->catalog_sequence, [&]() {
+			index = find_index(layout, code);
+		}))
+		{
+			return -1;
+		}
+		return index;
+	}
+
+	bool rate_table_get_rate(const RateTableLayout* layout, int from, int to, double& rate)
+	{
+		bool found = false;
+		bool read = seqlock_read(layout->catalog_sequence, [&]() {
+			found = false;
+			uint32_t count = layout->currency_count;
+			if (from < 0 || to < 0 || (uint32_t)from >= count || (uint32_t)to >= count || count > RATE_TABLE_MAX_CURRENCIES)
+			{
+				return;
+			}
+
+			// Direct rate if rates for the source currency were fetched
+			int64_t updated = 0;
+			double direct = 0.0;
+			if (!seqlock_read(layout->row_sequence[from], [&]() {
+				updated = layout->last_updated_at[from];
+				direct = layout->rates[from][to];
+			}))
+			{
+				return;
+			}
+			if (updated != 0 && direct > 0.0)
+			{
+				rate = direct;
+				found = true;
+				return;
+			}
+
+			// Otherwise cross over the pivot row. One fetched base is enough to answer every pair.
+			int32_t pivot = layout->pivot_index;
+			if (pivot < 0 || (uint32_t)pivot >= count)
+			{
+				return;
+			}
+			double pivot_to_from = 0.0;
+			double pivot_to_to = 0.0;
+			if (!seqlock_read(layout->row_sequence[pivot], [&]() {
+				updated = layout->last_updated_at[pivot];
+				pivot_to_from = layout->rates[pivot][from];
+				pivot_to_to = layout->rates[pivot][to];
+			}))
+			{
+				return;
+			}
+			if (updated != 0 && pivot_to_from > 0.0 && pivot_to_to > 0.0)
+			{
+				rate = pivot_to_to / pivot_to_from;
+				found = true;
+			}
+		});
+		return read && found;
+	}
+
+	bool rate_table_snapshot(const RateTableLayout* layout, RateTableSnapshot& snapshot)
+	{
+		// Cleared if a row couldn't be read
+		bool complete = true;
+		bool read = seqlock_read(layout->catalog_sequence, [&]() {
+			complete = true;
+			snapshot.catalog_sequence = layout->catalog_sequence.load(std::memory_order_relaxed);
+			snapshot.currency_count = layout->currency_count;
+			snapshot.pivot_index = layout->pivot_index;
+			if (snapshot.currency_count > RATE_TABLE_MAX_CURRENCIES)
+			{
+				snapshot.currency_count = 0;
+			}
+			uint32_t count = snapshot.currency_count;
+			memcpy(snapshot.codes, layout->codes, sizeof(snapshot.codes[0]) * count);
+			for (uint32_t i = 0; i < count; i++)
+			{
+				if (!seqlock_read(layout->row_sequence[i], [&]() {
+					snapshot.last_updated_at[i] = layout->last_updated_at[i];
+					memcpy(snapshot.rates[i], layout->rates[i], sizeof(double) * count);
+				}))
+				{
+					complete = false;
+					return;
+				}
+			}
+		});
+		return read && complete && snapshot.currency_count > 0;
+	}
+
+	int64_t parse_api_timestamp(const string& timestamp)
+	{
+		std::tm time {};
+		std::istringstream stream(timestamp);
+		stream >> std::get_time(&time, "%Y-%m-%dT%H:%M:%S");
+		if (stream.fail())
+		{
+			return 0;
+		}
+		// _mkgmtime is the utc counterpart of mktime on windows
+		return (int64_t)_mkgmtime(&time);
+	}
+
+	// ---------- RateTable ----------
+
+	RateTable::RateTable()
+	{
+		this->mapping = NULL;
+		this->layout = new RateTableLayout();
+		this->initialize_layout(this->layout);
+	}
+
+	RateTable::~RateTable()
+	{
+		if (this->mapping != NULL)
+		{
+			UnmapViewOfFile(this->layout);
+			CloseHandle(this->mapping);
+		}
+		else
+		{
+			delete this->layout;
+		}
+	}
+
+	void RateTable::initialize_layout(RateTableLayout* target)
+	{
+		target->version = RATE_TABLE_VERSION;
+		target->max_currencies = RATE_TABLE_MAX_CURRENCIES;
+		target->currency_count = 0;
+		target->pivot_index = -1;
+		// Magic comes last so that readers only accept a fully initialized table
+		std::atomic_thread_fence(std::memory_order_release);
+		target->magic = RATE_TABLE_MAGIC;
+	}
+
+	bool RateTable::open_shared(const wchar_t* name)
+	{
+		if (this->mapping != NULL)
+		{
+			return true;
+		}
+
+		HANDLE new_mapping = CreateFileMappingW(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, (DWORD)sizeof(RateTableLayout), name);
+		if (new_mapping == NULL)
+		{
+			return false;
+		}
+		// Only one publisher per segment is allowed because the seqlocks only support one writer.
+		if (GetLastError() == ERROR_ALREADY_EXISTS)
+		{
+			CloseHandle(new_mapping);
+			return false;
+		}
+
+		void* view = MapViewOfFile(new_mapping, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(RateTableLayout));
+		if (view == NULL)
+		{
+			CloseHandle(new_mapping);
+			return false;
+		}
+
+		// Fresh mappings are zeroed so constructing the layout in place only sets up the atomics.
+		RateTableLayout* shared = new (view) RateTableLayout();
+		shared->currency_count = this->layout->currency_count;
+		shared->pivot_index = this->layout->pivot_index;
+		memcpy(shared->codes, this->layout->codes, sizeof(shared->codes));
+		memcpy(shared->last_updated_at, this->layout->last_updated_at, sizeof(shared->last_updated_at));
+		memcpy(shared->rates, this->layout->rates, sizeof(shared->rates));
+		shared->version = RATE_TABLE_VERSION;
+		shared->max_currencies = RATE_TABLE_MAX_CURRENCIES;
+		std::atomic_thread_fence(std::memory_order_release);
+		shared->magic = RATE_TABLE_MAGIC;
+
+		delete this->layout;
+		this->layout = shared;
+		this->mapping = new_mapping;
+		return true;
+	}
+
+	bool RateTable::is_shared()
+	{
+		return this->mapping != NULL;
+	}
+
+	void RateTable::set_currencies(const std::map<string, Currency>& currencies)
+	{
+		begin_write(this->layout->catalog_sequence);
+
+		uint32_t count = 0;
+		for (auto& element : currencies)
+		{
+			if (count >= RATE_TABLE_MAX_CURRENCIES)
+			{
+				break;
+			}
+			// A cut off code could equal another one, e.g. "USDT" and "USDC"
+			if (element.first.size() >= RATE_TABLE_CODE_SIZE)
+			{
+				std::cerr << "\n\tCurrency code " << element.first << " is too long for the rate table and gets left out.\n";
+				continue;
+			}
+			memset(this->layout->codes[count], 0, sizeof(this->layout->codes[count]));
+			memcpy(this->layout->codes[count], element.first.data(), element.first.size());
+			count++;
+		}
+		this->layout->currency_count = count;
+		this->layout->pivot_index = -1;
+
+		// Indices changed so all rows are invalid now
+		for (uint32_t i = 0; i < RATE_TABLE_MAX_CURRENCIES; i++)
+		{
+			begin_write(this->layout->row_sequence[i]);
+			this->layout->last_updated_at[i] = 0;
+			memset(this->layout->rates[i], 0, sizeof(this->layout->rates[i]));
+			end_write(this->layout->row_sequence[i]);
+		}
+
+		end_write(this->layout->catalog_sequence);
+	}
+
+	void RateTable::update_row(const string& base_code, const std::map<string, float>& exchange_rates, int64_t last_updated_at)
+	{
+		int row = find_index(this->layout, base_code.c_str());
+		if (row < 0)
+		{
+			return;
+		}
+
+		// A row without timestamp would look empty to readers
+		if (last_updated_at == 0)
+		{
+			last_updated_at = (int64_t)time(nullptr);
+		}
+
+		begin_write(this->layout->row_sequence[row]);
+		this->layout->last_updated_at[row] = last_updated_at;
+		// Codes and exchange_rates are both sorted by code, so one pass over both finds every column.
+		// Looking up each code separately made this quadratic in the number of currencies.
+		uint32_t count = this->layout->currency_count;
+		auto entry = exchange_rates.begin();
+		for (uint32_t column = 0; column < count; column++)
+		{
+			while (entry != exchange_rates.end() && strncmp(entry->first.c_str(), this->layout->codes[column], RATE_TABLE_CODE_SIZE) < 0)
+			{
+				entry++;
+			}
+			// Columns without a new rate get cleared. Keeping the old one would keep pairs alive that upstream doesn't quote anymore.
+			if (entry != exchange_rates.end() && strncmp(entry->first.c_str(), this->layout->codes[column], RATE_TABLE_CODE_SIZE) == 0)
+			{
+				this->layout->rates[row][column] = entry->second;
+			}
+			else
+			{
+				this->layout->rates[row][column] = 0.0;
+			}
+		}
+		end_write(this->layout->row_sequence[row]);
+
+		if (this->layout->pivot_index < 0)
+		{
+			begin_write(this->layout->catalog_sequence);
+			this->layout->pivot_index = row;
+			end_write(this->layout->catalog_sequence);
+		}
+
+		for (auto& subscriber : this->subscribers)
+		{
+			subscriber(base_code, exchange_rates, last_updated_at);
+		}
+	}
+
+	void RateTable::subscribe(RateUpdateCallback callback)
+	{
+		this->subscribers.push_back(callback);
+	}
+
+	int RateTable::index_of(const string& code)
+	{
+		return rate_table_index_of(this->layout, code.c_str());
+	}
+
+	bool RateTable::get_rate(int from, int to, double& rate)
+	{
+		return rate_table_get_rate(this->layout, from, to, rate);
+	}
+
+	bool RateTable::snapshot(RateTableSnapshot& snapshot)
+	{
+		return rate_table_snapshot(this->layout, snapshot);
+	}
+
+	uint64_t RateTable::row_version(int row)
+	{
+		if (row < 0 || (uint32_t)row >= RATE_TABLE_MAX_CURRENCIES)
+		{
+			return 0;
+		}
+		return this->layout->row_sequence[row].load(std::memory_order_acquire);
+	}
+}
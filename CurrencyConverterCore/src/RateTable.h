@@ -0,0 +1,134 @@
+#pragma once
+#include <string>
+#include <map>
+#include <vector>
+#include <functional>
+#include <atomic>
+#include <cstdint>
+#include <windows.h>
+
+#include "Currency.h"
+
+namespace CurrencyConverter
+{
+	using std::string;
+
+	// Name of the shared memory segment the publisher writes to and readers open.
+	// "Local\" keeps the segment inside the current login session so no special privileges are needed.
+	constexpr const wchar_t* SHARED_RATES_NAME = L"Local\\CurrencyConverterRates";
+
+	// Used by readers to verify that the mapped memory really is a rate table of a layout they understand.
+	constexpr uint32_t RATE_TABLE_MAGIC = 0x54524343; // "CCRT"
+	// Version 1 had room for 3 letter codes only
+	constexpr uint32_t RATE_TABLE_VERSION = 2;
+
+	// Gets every row update_row() publishes, e.g. to keep statistics of the rates (see RateAnalytics.h)
+	using RateUpdateCallback = std::function<void(const string& base_code, const std::map<string, float>& exchange_rates, int64_t last_updated_at)>;
+
+	// Freecurrencyapi.com has 32 currencies and currencyapi.com has 172.
+	// The layout is fixed so that every process agrees on it without negotiating anything.
+	constexpr uint32_t RATE_TABLE_MAX_CURRENCIES = 192;
+	// Bytes per currency code including the terminating zero. Currencyapi.com has codes like "USDT" and "MATIC".
+	// Longer codes don't get a row.
+	constexpr uint32_t RATE_TABLE_CODE_SIZE = 8;
+
+	// Fixed memory layout of the rate table.
+	// The same layout is used for the in-process table and for the shared memory segment.
+	//
+	// Synchronisation is done with seqlocks and there is only ever one writer.
+	// A sequence number is odd while the writer is changing the data it guards and even otherwise.
+	// Readers read the sequence number, copy the data and read the sequence number again.
+	// If both reads are equal and even the copy is consistent, otherwise the reader just tries again.
+	// That way readers never block the writer and never need a syscall or a lock.
+	// Readers give up after RATE_TABLE_READ_ATTEMPTS, so a publisher that dies in the middle of a write can't hang them.
+	//
+	// catalog_sequence guards currency_count, codes and pivot_index.
+	// row_sequence[i] guards last_updated_at[i] and rates[i].
+	struct RateTableLayout {
+		uint32_t magic;
+		uint32_t version;
+		uint32_t max_currencies;
+		uint32_t currency_count;
+
+		std::atomic<uint64_t> catalog_sequence;
+
+		// Index of the first row that received rates or -1.
+		// Rows that were never fetched are answered by crossing over this row.
+		int32_t pivot_index;
+		uint32_t padding;
+
+		// Currency codes sorted like AppState::currencies, zero terminated
+		char codes[RATE_TABLE_MAX_CURRENCIES][RATE_TABLE_CODE_SIZE];
+
+		// Value of meta.last_updated_at of the row as unix timestamp. 0 means the row has no rates.
+		int64_t last_updated_at[RATE_TABLE_MAX_CURRENCIES];
+
+		std::atomic<uint64_t> row_sequence[RATE_TABLE_MAX_CURRENCIES];
+
+		// rates[from][to] -> amount of "to" for one unit of "from"
+		double rates[RATE_TABLE_MAX_CURRENCIES][RATE_TABLE_MAX_CURRENCIES];
+	};
+
+	// Consistent copy of a whole rate table.
+	// Big (~300KB) so it should be allocated once and reused.
+	struct RateTableSnapshot {
+		uint64_t catalog_sequence;
+		uint32_t currency_count;
+		int32_t pivot_index;
+		char codes[RATE_TABLE_MAX_CURRENCIES][RATE_TABLE_CODE_SIZE];
+		int64_t last_updated_at[RATE_TABLE_MAX_CURRENCIES];
+		double rates[RATE_TABLE_MAX_CURRENCIES][RATE_TABLE_MAX_CURRENCIES];
+	};
+
+	// Tries of a reader before it gives up on a sequence number that stays odd. Writes take microseconds, this is tens of milliseconds.
+	constexpr uint32_t RATE_TABLE_READ_ATTEMPTS = 1 << 20;
+
+	// Seqlock readers. Shared between the in-process RateTable and SharedRatesReader.
+	// All of them return false (-1 for the index) if the table doesn't contain the requested data
+	// or a write didn't finish within RATE_TABLE_READ_ATTEMPTS.
+	int rate_table_index_of(const RateTableLayout* layout, const char* code);
+	bool rate_table_get_rate(const RateTableLayout* layout, int from, int to, double& rate);
+	bool rate_table_snapshot(const RateTableLayout* layout, RateTableSnapshot& snapshot);
+
+	// Converts the "2022-01-01T23:59:59Z" timestamps of the api into unix timestamps. Returns 0 on invalid input.
+	int64_t parse_api_timestamp(const string& timestamp);
+
+	// Table of all exchange rates known to this process.
+	// Backed by heap memory by default and by a named shared memory segment after open_shared() succeeded.
+	class RateTable {
+	public:
+		RateTable();
+		~RateTable();
+
+		RateTable(const RateTable&) = delete;
+		RateTable& operator=(const RateTable&) = delete;
+
+		// Moves the table into the shared memory segment so that other processes can read it.
+		// The current content is copied over. Returns false if the segment couldn't be created.
+		bool open_shared(const wchar_t* name = SHARED_RATES_NAME);
+		bool is_shared();
+
+		// Writer side. Must only be called from one thread at a time.
+		// Replaces the currency list. All rows get cleared because the indices change.
+		// Codes that don't fit into RATE_TABLE_CODE_SIZE are left out and reported.
+		void set_currencies(const std::map<string, Currency>& currencies);
+		// Replaces all rates of one base currency. Currencies missing from exchange_rates have no rate in this row afterwards.
+		void update_row(const string& base_code, const std::map<string, float>& exchange_rates, int64_t last_updated_at);
+		// Called on the writer thread after every update_row() of a known currency
+		void subscribe(RateUpdateCallback callback);
+
+		// Reader side. Safe to call from any thread.
+		int index_of(const string& code);
+		bool get_rate(int from, int to, double& rate);
+		bool snapshot(RateTableSnapshot& snapshot);
+		// Changes every time the row gets new rates. Odd while the writer is busy with it. 0 for invalid rows.
+		uint64_t row_version(int row);
+
+	private:
+		RateTableLayout* layout;
+		HANDLE mapping;
+		std::vector<RateUpdateCallback> subscribers;
+
+		void initialize_layout(RateTableLayout* target);
+	};
+}
@@ -0,0 +1,282 @@
+#include "ReplayDriver.h"
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <iomanip>
+#include <stdexcept>
+#include <ctime>
+
+#include "Core.h"
+#include "SessionTrace.h"
+
+namespace CurrencyConverter
+{
+	ReplayOptions::ReplayOptions()
+	{
+		this->path = "";
+		this->speed = 1.0;
+		this->user_count = 1;
+		this->repeat_count = 1;
+	}
+
+	// Everything one simulated user produces. Aligned so that users don't share cache lines.
+	struct alignas(64) UserResult {
+		uint64_t sessions;
+		uint64_t commands;
+		uint64_t errors;
+		// Keeps the compiler from optimizing list and lookup away
+		uint64_t checksum;
+		LatencyHistogram start_up_duration;
+		LatencyHistogram list_duration;
+		LatencyHistogram lookup_duration;
+		LatencyHistogram convert_duration;
+		LatencyHistogram refresh_duration;
+		LatencyHistogram statistics_duration;
+		LatencyHistogram start_delay;
+	};
+
+	// Does what the menu option of the event did in the recorded session
+	static void run_command(AppState& app_state, const TraceEvent& event, UserResult& result)
+	{
+		switch (event.type)
+		{
+			case TraceEventType::Start:
+				start_up(app_state, event.codes);
+				return;
+			case TraceEventType::List:
+				for (auto& currency : app_state.currencies)
+				{
+					result.checksum += currency.first.size();
+				}
+				return;
+			case TraceEventType::Lookup:
+				if (!event.codes.empty())
+				{
+					result.checksum += app_state.currencies.contains(event.codes[0]) ? 1 : app_state.currency_search.resolve(event.codes[0]).size();
+				}
+				return;
+			case TraceEventType::Convert:
+				{
+					if (event.codes.size() < 2 || !app_state.currencies.contains(event.codes[0]))
+					{
+						throw new std::runtime_error("Unknown currency in trace!");
+					}
+					Currency& source = app_state.currencies[event.codes[0]];
+					if (source.exchange_rates.empty())
+					{
+						get_exchange_rates(app_state, source);
+					}
+					// Conversions at an average rate have its window as third code
+					int64_t twap_window = 0;
+					if (event.codes.size() > 2 && !parse_window(event.codes[2], twap_window))
+					{
+						throw new std::runtime_error("Unknown window in trace!");
+					}
+					result.checksum += (uint64_t)convert_money(app_state, event.codes[0], event.codes[1], event.amount, twap_window);
+					return;
+				}
+			case TraceEventType::Statistics:
+				{
+					if (event.codes.size() < 2 || !app_state.currencies.contains(event.codes[0]))
+					{
+						throw new std::runtime_error("Unknown currency in trace!");
+					}
+					Currency& source = app_state.currencies[event.codes[0]];
+					if (source.exchange_rates.empty())
+					{
+						get_exchange_rates(app_state, source);
+					}
+					RateStatistics statistics {};
+					for (auto window : app_state.rate_analytics.get_windows())
+					{
+						if (app_state.rate_analytics.get_statistics(event.codes[0], event.codes[1], window, app_state.now(), statistics))
+						{
+							result.checksum += statistics.samples;
+						}
+					}
+					return;
+				}
+			case TraceEventType::Refresh:
+				refresh_data(app_state);
+				return;
+			default:
+				return;
+		}
+	}
+
+	static LatencyHistogram& duration_of(UserResult& result, TraceEventType type)
+	{
+		switch (type)
+		{
+			case TraceEventType::Start:
+				return result.start_up_duration;
+			case TraceEventType::List:
+				return result.list_duration;
+			case TraceEventType::Lookup:
+				return result.lookup_duration;
+			case TraceEventType::Convert:
+				return result.convert_duration;
+			case TraceEventType::Statistics:
+				return result.statistics_duration;
+			default:
+				return result.refresh_duration;
+		}
+	}
+
+	static void run_user(const SessionTrace& trace, const ReplayOptions& options, std::chrono::steady_clock::time_point started, UserResult& result)
+	{
+		for (uint32_t session = 0; session < options.repeat_count; session++)
+		{
+			// Every session starts from nothing like a freshly started program
+			std::unique_ptr<AppState> app_state = std::make_unique<AppState>();
+			app_state->api_keys.add_all("replay");
+			ResponseReplay replay(trace);
+			app_state->response_replay = &replay;
+
+			std::chrono::steady_clock::time_point session_started = session == 0 ? started : std::chrono::steady_clock::now();
+			for (auto& event : trace.events)
+			{
+				if (event.type == TraceEventType::Response)
+				{
+					continue;
+				}
+
+				if (options.speed > 0.0)
+				{
+					auto due = session_started + std::chrono::microseconds((int64_t)((double)event.at_microseconds / options.speed));
+					std::this_thread::sleep_until(due);
+					auto delay = std::chrono::steady_clock::now() - due;
+					result.start_delay.record((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(delay).count());
+				}
+
+				// The clock of the session is the recorded one, no matter how fast or how often it gets replayed
+				app_state->replayed_time = (trace.started_at + event.at_microseconds) / 1000000;
+
+				auto command_started = std::chrono::steady_clock::now();
+				try
+				{
+					run_command(*app_state, event, result);
+				}
+				catch (std::runtime_error* e)
+				{
+					// The core reports its errors like this
+					delete e;
+					result.errors++;
+				}
+				catch (std::exception&)
+				{
+					result.errors++;
+				}
+				auto duration = std::chrono::steady_clock::now() - command_started;
+				duration_of(result, event.type).record((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+				result.commands++;
+			}
+			result.sessions++;
+		}
+	}
+
+	bool run_replay(const ReplayOptions& options, ReplayReport& report)
+	{
+		report.options = options;
+		report.sessions = 0;
+		report.commands = 0;
+		report.errors = 0;
+		report.elapsed_seconds = 0.0;
+		report.start_up_duration.clear();
+		report.list_duration.clear();
+		report.lookup_duration.clear();
+		report.convert_duration.clear();
+		report.refresh_duration.clear();
+		report.statistics_duration.clear();
+		report.start_delay.clear();
+
+		SessionTrace trace;
+		if (!load_session_trace(options.path, trace))
+		{
+			return false;
+		}
+		report.trace_events = trace.events.size();
+
+		std::vector<UserResult> results(options.user_count);
+		std::vector<std::thread> users {};
+		auto started = std::chrono::steady_clock::now();
+		for (uint32_t i = 0; i < options.user_count; i++)
+		{
+			results[i].sessions = 0;
+			results[i].commands = 0;
+			results[i].errors = 0;
+			results[i].checksum = 0;
+			users.emplace_back(run_user, std::cref(trace), std::cref(options), started, std::ref(results[i]));
+		}
+		for (auto& user : users)
+		{
+			user.join();
+		}
+		report.elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+		for (auto& result : results)
+		{
+			report.sessions += result.sessions;
+			report.commands += result.commands;
+			report.errors += result.errors;
+			report.start_up_duration.merge(result.start_up_duration);
+			report.list_duration.merge(result.list_duration);
+			report.lookup_duration.merge(result.lookup_duration);
+			report.convert_duration.merge(result.convert_duration);
+			report.refresh_duration.merge(result.refresh_duration);
+			report.statistics_duration.merge(result.statistics_duration);
+			report.start_delay.merge(result.start_delay);
+		}
+		return true;
+	}
+
+	void write_replay_report(std::ostream& stream, const ReplayReport& report)
+	{
+		double seconds = report.elapsed_seconds > 0.0 ? report.elapsed_seconds : 1.0;
+		std::ios_base::fmtflags flags = stream.flags();
+		std::streamsize precision = stream.precision();
+
+		stream << "---------- Session replay ----------" << '\n';
+		stream << report.options.path << ": " << report.trace_events << " events, " << report.options.user_count << " users, ";
+		if (report.options.speed > 0.0)
+		{
+			stream << report.options.speed << "x speed";
+		}
+		else
+		{
+			stream << "no waiting";
+		}
+		stream << ", " << std::fixed << std::setprecision(1) << report.elapsed_seconds << "s" << '\n';
+
+		stream << "Sessions:         " << report.sessions << " (" << std::setprecision(1) << (double)report.sessions / seconds << "/s)" << '\n';
+		stream << "Commands:         " << report.commands << " (" << (double)report.commands / seconds << "/s), " << report.errors << " failed" << '\n';
+
+		// Options that weren't used in the trace are left out
+		struct Line {
+			const char* label;
+			const LatencyHistogram& histogram;
+		};
+		const Line lines[] = {
+			{ "Start up:         ", report.start_up_duration },
+			{ "List:             ", report.list_duration },
+			{ "Lookup:           ", report.lookup_duration },
+			{ "Convert:          ", report.convert_duration },
+			{ "Refresh:          ", report.refresh_duration },
+			{ "Statistics:       ", report.statistics_duration },
+			{ "Start delay:      ", report.start_delay },
+		};
+		for (auto& line : lines)
+		{
+			if (line.histogram.count() > 0)
+			{
+				stream << line.label;
+				line.histogram.write_summary(stream);
+				stream << '\n';
+			}
+		}
+
+		stream.flags(flags);
+		stream.precision(precision);
+	}
+}
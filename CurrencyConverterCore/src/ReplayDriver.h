@@ -0,0 +1,51 @@
+#pragma once
+#include <string>
+#include <cstdint>
+#include <ostream>
+
+#include "LatencyHistogram.h"
+
+namespace CurrencyConverter
+{
+	using std::string;
+
+	struct ReplayOptions {
+		ReplayOptions();
+
+		// Trace file written with --record
+		string path;
+		// 1 replays in recorded time, 1000 a thousand times faster. 0 doesn't wait between commands at all.
+		double speed;
+		// Simulated users. Every user replays the whole trace on its own thread with its own AppState.
+		uint32_t user_count;
+		// How often every user replays the trace
+		uint32_t repeat_count;
+	};
+
+	struct ReplayReport {
+		ReplayOptions options;
+		// Events of the loaded trace
+		uint64_t trace_events;
+		uint64_t sessions;
+		uint64_t commands;
+		// Commands that threw
+		uint64_t errors;
+		double elapsed_seconds;
+		// Duration of the commands by menu option, including the handling of replayed responses
+		LatencyHistogram start_up_duration;
+		LatencyHistogram list_duration;
+		LatencyHistogram lookup_duration;
+		LatencyHistogram convert_duration;
+		LatencyHistogram refresh_duration;
+		LatencyHistogram statistics_duration;
+		// How late commands started compared to the (accelerated) recorded timing. Grows when the program can't keep up.
+		LatencyHistogram start_delay;
+	};
+
+	// Load test with recorded usage. Runs the commands of a session trace (see SessionTrace.h) against the core
+	// without console and without network: every request gets the response that was recorded for it.
+	// Returns false if the trace can't be loaded. The report is big, so it is filled in place.
+	bool run_replay(const ReplayOptions& options, ReplayReport& report);
+
+	void write_replay_report(std::ostream& stream, const ReplayReport& report);
+}
@@ -0,0 +1,222 @@
+#include "SessionTrace.h"
+#include <cstring>
+#include <sstream>
+
+#include "BinaryEncoding.h"
+
+namespace CurrencyConverter
+{
+	static bool read_event(const char*& position, const char* end, int64_t& at_microseconds, TraceEvent& event)
+	{
+		uint8_t type = (uint8_t)*position;
+		position++;
+		uint64_t delta = 0;
+		if (!read_varint(position, end, delta))
+		{
+			return false;
+		}
+		at_microseconds += (int64_t)delta;
+
+		event = TraceEvent();
+		event.type = (TraceEventType)type;
+		event.at_microseconds = at_microseconds;
+		event.amount = 0.0;
+
+		switch (event.type)
+		{
+			case TraceEventType::Start:
+			case TraceEventType::List:
+			case TraceEventType::Lookup:
+			case TraceEventType::Convert:
+			case TraceEventType::Refresh:
+			case TraceEventType::Statistics:
+			{
+				uint64_t count = 0;
+				if (!read_varint(position, end, count))
+				{
+					return false;
+				}
+				for (uint64_t i = 0; i < count; i++)
+				{
+					string code = "";
+					if (!read_bytes(position, end, code))
+					{
+						return false;
+					}
+					event.codes.push_back(code);
+				}
+				return read_double(position, end, event.amount);
+			}
+			case TraceEventType::Response:
+			{
+				uint64_t response_code = 0;
+				if (!read_bytes(position, end, event.request) || !read_varint(position, end, response_code))
+				{
+					return false;
+				}
+				event.response.response_code = (long)response_code;
+				return read_bytes(position, end, event.response.headers)
+					&& read_bytes(position, end, event.response.body)
+					&& read_bytes(position, end, event.response.error);
+			}
+			default:
+				return false;
+		}
+	}
+
+	bool load_session_trace(const string& path, SessionTrace& trace)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file)
+		{
+			return false;
+		}
+		std::stringstream content;
+		content << file.rdbuf();
+		string data = content.str();
+
+		size_t magic_length = strlen(TRACE_MAGIC);
+		if (data.size() < magic_length + 1 || data.compare(0, magic_length, TRACE_MAGIC) != 0 || (uint8_t)data[magic_length] != TRACE_VERSION)
+		{
+			return false;
+		}
+
+		trace.events.clear();
+		const char* position = data.data() + magic_length + 1;
+		const char* end = data.data() + data.size();
+		uint64_t started_at = 0;
+		if (!read_varint(position, end, started_at))
+		{
+			return false;
+		}
+		trace.started_at = (int64_t)started_at;
+		int64_t at_microseconds = 0;
+		while (position < end)
+		{
+			TraceEvent event;
+			if (!read_event(position, end, at_microseconds, event))
+			{
+				break;
+			}
+			trace.events.push_back(std::move(event));
+		}
+		return true;
+	}
+
+	TraceRecorder::TraceRecorder()
+	{
+		this->last_microseconds = 0;
+		this->buffer = "";
+	}
+
+	TraceRecorder::~TraceRecorder()
+	{
+	}
+
+	bool TraceRecorder::open(const string& path)
+	{
+		this->file.open(path, std::ios::binary | std::ios::trunc);
+		if (!this->file)
+		{
+			return false;
+		}
+		this->file.write(TRACE_MAGIC, (std::streamsize)strlen(TRACE_MAGIC));
+		this->file.put((char)TRACE_VERSION);
+		// Replays run on this clock, see AppState::replayed_time
+		int64_t started_at = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+		this->buffer.clear();
+		write_varint(this->buffer, (uint64_t)started_at);
+		this->file.write(this->buffer.data(), (std::streamsize)this->buffer.size());
+		this->started = std::chrono::steady_clock::now();
+		this->last_microseconds = 0;
+		return true;
+	}
+
+	bool TraceRecorder::is_open()
+	{
+		return this->file.is_open();
+	}
+
+	void TraceRecorder::begin_record(TraceEventType type)
+	{
+		int64_t now = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - this->started).count();
+		this->buffer.clear();
+		this->buffer.push_back((char)type);
+		write_varint(this->buffer, (uint64_t)(now - this->last_microseconds));
+		this->last_microseconds = now;
+	}
+
+	void TraceRecorder::end_record()
+	{
+		// Every record gets flushed so that the trace survives a crash of the session it records
+		this->file.write(this->buffer.data(), (std::streamsize)this->buffer.size());
+		this->file.flush();
+	}
+
+	void TraceRecorder::record(TraceEventType type, const std::vector<string>& codes, double amount)
+	{
+		if (!this->is_open())
+		{
+			return;
+		}
+		this->begin_record(type);
+		write_varint(this->buffer, codes.size());
+		for (auto& code : codes)
+		{
+			write_bytes(this->buffer, code);
+		}
+		write_double(this->buffer, amount);
+		this->end_record();
+	}
+
+	void TraceRecorder::record_response(const string& request, const FetchResponse& response)
+	{
+		if (!this->is_open())
+		{
+			return;
+		}
+		this->begin_record(TraceEventType::Response);
+		write_bytes(this->buffer, request);
+		write_varint(this->buffer, (uint64_t)response.response_code);
+		write_bytes(this->buffer, response.headers);
+		write_bytes(this->buffer, response.body);
+		write_bytes(this->buffer, response.error);
+		this->end_record();
+	}
+
+	ResponseReplay::ResponseReplay(const SessionTrace& trace)
+	{
+		for (auto& event : trace.events)
+		{
+			if (event.type == TraceEventType::Response)
+			{
+				this->pending[event.request].push_back(&event.response);
+			}
+		}
+	}
+
+	ResponseReplay::~ResponseReplay()
+	{
+	}
+
+	FetchResponse ResponseReplay::next(const string& request)
+	{
+		auto queue = this->pending.find(request);
+		if (queue != this->pending.end() && !queue->second.empty())
+		{
+			this->last[request] = queue->second.front();
+			queue->second.pop_front();
+			return *this->last[request];
+		}
+		if (this->last.contains(request))
+		{
+			return *this->last[request];
+		}
+
+		// Looks like a failed transfer to the response handlers
+		FetchResponse missing {};
+		missing.response_code = 0;
+		missing.error = "No response for " + request + " in the trace";
+		return missing;
+	}
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <deque>
+#include <fstream>
+#include <chrono>
+#include <cstdint>
+
+#include "AsyncFetch.h"
+
+namespace CurrencyConverter
+{
+	using std::string;
+
+	// Session traces record what a user did and what the api answered, so that the session can be replayed
+	// later without console and without network (see ReplayDriver.h).
+	//
+	// File layout: "CCTR", version byte, unix time in microseconds when recording started (varint),
+	// then records until the end of the file.
+	// Every record is a type byte, the microseconds since the previous record as varint and the fields of its type.
+	// Strings are varint length plus bytes, amounts are 8 byte doubles. See BinaryEncoding.h.
+	constexpr const char* TRACE_MAGIC = "CCTR";
+	// Version 1 had no start time
+	constexpr uint8_t TRACE_VERSION = 2;
+
+	enum class TraceEventType : uint8_t {
+		// Program start. codes: prefetched base currencies
+		Start = 1,
+		// Menu option A
+		List = 2,
+		// Menu option B. codes[0]: what the user typed to find the currency
+		Lookup = 3,
+		// Menu option C. codes[0]: source, codes[1]: target, codes[2]: window of the average rate if one was used
+		Convert = 4,
+		// Menu option R
+		Refresh = 5,
+		// Answer of the api. request: which request it answers, see request_name in Core.h
+		Response = 6,
+		// Menu option S. codes[0]: source, codes[1]: target
+		Statistics = 7
+	};
+
+	struct TraceEvent {
+		TraceEventType type;
+		// Since the start of the session
+		int64_t at_microseconds;
+		std::vector<string> codes;
+		double amount;
+		string request;
+		FetchResponse response;
+	};
+
+	struct SessionTrace {
+		// Unix time in microseconds. Start time plus at_microseconds is the time of an event on the recording machine.
+		int64_t started_at;
+		std::vector<TraceEvent> events;
+	};
+
+	// Reads a whole trace file. Returns false if the file can't be read or isn't a trace.
+	// A record cut off at the end (e.g. after a crash) is ignored.
+	bool load_session_trace(const string& path, SessionTrace& trace);
+
+	// Writes events of the running session to a trace file as they happen
+	class TraceRecorder {
+	public:
+		TraceRecorder();
+		~TraceRecorder();
+
+		TraceRecorder(const TraceRecorder&) = delete;
+		TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+		bool open(const string& path);
+		bool is_open();
+
+		void record(TraceEventType type, const std::vector<string>& codes = {}, double amount = 0.0);
+		void record_response(const string& request, const FetchResponse& response);
+
+	private:
+		std::ofstream file;
+		std::chrono::steady_clock::time_point started;
+		int64_t last_microseconds;
+		// Reused for every record
+		string buffer;
+
+		void begin_record(TraceEventType type);
+		void end_record();
+	};
+
+	// Hands out the recorded responses of a trace instead of asking the api. One per replayed session.
+	// Responses to the same request come in the recorded order.
+	// When a request is made more often than it was recorded the last response gets repeated.
+	class ResponseReplay {
+	public:
+		ResponseReplay(const SessionTrace& trace);
+		~ResponseReplay();
+
+		FetchResponse next(const string& request);
+
+	private:
+		std::map<string, std::deque<const FetchResponse*>> pending;
+		std::map<string, const FetchResponse*> last;
+	};
+}
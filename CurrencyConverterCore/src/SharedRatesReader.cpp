@@ -0,0 +1,110 @@
+#include "SharedRatesReader.h"
+
+namespace CurrencyConverter
+{
+	SharedRatesReader::SharedRatesReader()
+	{
+		this->mapping = NULL;
+		this->layout = nullptr;
+	}
+
+	SharedRatesReader::~SharedRatesReader()
+	{
+		this->close();
+	}
+
+	bool SharedRatesReader::open(const wchar_t* name)
+	{
+		this->close();
+
+		this->mapping = OpenFileMappingW(FILE_MAP_READ, FALSE, name);
+		if (this->mapping == NULL)
+		{
+			return false;
+		}
+
+		const void* view = MapViewOfFile(this->mapping, FILE_MAP_READ, 0, 0, sizeof(RateTableLayout));
+		if (view == NULL)
+		{
+			this->close();
+			return false;
+		}
+		this->layout = static_cast<const RateTableLayout*>(view);
+
+		// Refuse tables of other layouts instead of reading garbage
+		if (this->layout->magic != RATE_TABLE_MAGIC || this->layout->version != RATE_TABLE_VERSION || this->layout->max_currencies != RATE_TABLE_MAX_CURRENCIES)
+		{
+			this->close();
+			return false;
+		}
+		std::atomic_thread_fence(std::memory_order_acquire);
+		return true;
+	}
+
+	void SharedRatesReader::close()
+	{
+		if (this->layout != nullptr)
+		{
+			UnmapViewOfFile(this->layout);
+			this->layout = nullptr;
+		}
+		if (this->mapping != NULL)
+		{
+			CloseHandle(this->mapping);
+			this->mapping = NULL;
+		}
+	}
+
+	bool SharedRatesReader::is_open()
+	{
+		return this->layout != nullptr;
+	}
+
+	int SharedRatesReader::index_of(const char* code)
+	{
+		if (this->layout == nullptr)
+		{
+			return -1;
+		}
+		return rate_table_index_of(this->layout, code);
+	}
+
+	uint64_t SharedRatesReader::catalog_version()
+	{
+		if (this->layout == nullptr)
+		{
+			return 0;
+		}
+		// Writes in progress are rounded down so that the version only changes once per catalog update
+		return this->layout->catalog_sequence.load(std::memory_order_acquire) & ~(uint64_t)1;
+	}
+
+	bool SharedRatesReader::get_rate(int from, int to, double& rate)
+	{
+		if (this->layout == nullptr)
+		{
+			return false;
+		}
+		return rate_table_get_rate(this->layout, from, to, rate);
+	}
+
+	bool SharedRatesReader::convert(int from, int to, double amount, double& result)
+	{
+		double rate = 0.0;
+		if (!this->get_rate(from, to, rate))
+		{
+			return false;
+		}
+		result = amount * rate;
+		return true;
+	}
+
+	bool SharedRatesReader::snapshot(RateTableSnapshot& snapshot)
+	{
+		if (this->layout == nullptr)
+		{
+			return false;
+		}
+		return rate_table_snapshot(this->layout, snapshot);
+	}
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <string>
+#include <windows.h>
+
+#include "RateTable.h"
+
+namespace CurrencyConverter
+{
+	// Read only client for the rate table a publisher ("CurrencyConverter.exe <API_KEY> --publish") shares with the host.
+	// Meant to be compiled into other processes. Only depends on RateTable.h/.cpp.
+	//
+	// Usage:
+	//     SharedRatesReader reader;
+	//     if (reader.open()) {
+	//         int eur = reader.index_of("EUR");
+	//         int usd = reader.index_of("USD");
+	//         double result;
+	//         reader.convert(eur, usd, 100.0, result);
+	//     }
+	//
+	// Indices stay valid as long as catalog_version() doesn't change.
+	// All reads are lock free and never enter the kernel.
+	// If the publisher died in the middle of a write, the table stays half written: index_of() returns -1 and
+	// get_rate(), convert() and snapshot() return false after spinning for a few tens of milliseconds. Close the reader then,
+	// a new publisher can only create the segment once every reader let go of the old one.
+	class SharedRatesReader {
+	public:
+		SharedRatesReader();
+		~SharedRatesReader();
+
+		SharedRatesReader(const SharedRatesReader&) = delete;
+		SharedRatesReader& operator=(const SharedRatesReader&) = delete;
+
+		// Maps the segment read only. Returns false if there is no publisher or the layout is unknown.
+		bool open(const wchar_t* name = SHARED_RATES_NAME);
+		void close();
+		bool is_open();
+
+		int index_of(const char* code);
+		uint64_t catalog_version();
+
+		bool get_rate(int from, int to, double& rate);
+		bool convert(int from, int to, double amount, double& result);
+		bool snapshot(RateTableSnapshot& snapshot);
+
+	private:
+		HANDLE mapping;
+		const RateTableLayout* layout;
+	};
+}
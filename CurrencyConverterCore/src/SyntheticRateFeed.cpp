@@ -0,0 +1,84 @@
+#include "SyntheticRateFeed.h"
+#include <cmath>
+
+namespace CurrencyConverter
+{
+	SyntheticRateFeed::SyntheticRateFeed(const std::map<string, Currency>& currencies, double volatility, uint64_t seed)
+	{
+		this->next_base = 0;
+		this->ticks = 0;
+		this->random = std::mt19937_64(seed);
+		this->step = std::normal_distribution<double>(0.0, volatility);
+
+		// Starting prices spread over a few orders of magnitude like real rates (JPY vs KWD)
+		std::uniform_real_distribution<double> magnitude(-4.0, 4.0);
+		for (auto& element : currencies)
+		{
+			this->codes.push_back(element.first);
+			this->prices.push_back(std::exp(magnitude(this->random)));
+		}
+
+		std::map<string, float> row {};
+		for (auto& code : this->codes)
+		{
+			row[code] = 1.0f;
+		}
+		this->rows.assign(this->codes.size(), row);
+	}
+
+	SyntheticRateFeed::~SyntheticRateFeed()
+	{
+	}
+
+	int SyntheticRateFeed::next_row()
+	{
+		// Currencies are sorted the same way in the rate table, so positions are row indices
+		return (int)this->next_base;
+	}
+
+	void SyntheticRateFeed::tick(RateTable& rate_table, int64_t last_updated_at)
+	{
+		if (this->codes.empty())
+		{
+			return;
+		}
+
+		for (auto& price : this->prices)
+		{
+			price *= std::exp(this->step(this->random));
+		}
+
+		// Map and prices are both in code order, so no lookups are needed
+		double base_price = this->prices[this->next_base];
+		size_t target = 0;
+		for (auto& entry : this->rows[this->next_base])
+		{
+			entry.second = (float)(this->prices[target] / base_price);
+			target++;
+		}
+
+		rate_table.update_row(this->codes[this->next_base], this->rows[this->next_base], last_updated_at);
+
+		this->next_base = (this->next_base + 1) % this->codes.size();
+		this->ticks++;
+	}
+
+	uint64_t SyntheticRateFeed::tick_count()
+	{
+		return this->ticks;
+	}
+
+	std::map<string, Currency> make_synthetic_currencies(uint32_t count)
+	{
+		std::map<string, Currency> currencies {};
+		for (uint32_t i = 0; i < count && i < 26 * 26 * 26; i++)
+		{
+			string code = "";
+			code.push_back((char)('A' + i / (26 * 26)));
+			code.push_back((char)('A' + (i / 26) % 26));
+			code.push_back((char)('A' + i % 26));
+			currencies[code] = Currency(code, "Synthetic " + code, code, 2, 0, code, "Synthetic " + code);
+		}
+		return currencies;
+	}
+}
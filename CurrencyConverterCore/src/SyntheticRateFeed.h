@@ -0,0 +1,45 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <random>
+#include <cstdint>
+
+#include "Currency.h"
+#include "RateTable.h"
+
+namespace CurrencyConverter
+{
+	using std::string;
+
+	// Made up exchange rates that change on every tick. Used to load the rate table with far more updates than upstream produces.
+	//
+	// Every currency has a price that does a random walk (geometric brownian motion without drift).
+	// A tick moves all prices one step and publishes the rates of the next base currency, round robin,
+	// through RateTable::update_row(), the same call the exchange rates response handler uses.
+	// Rates are ratios of prices, so cross rates over any base always agree with each other.
+	class SyntheticRateFeed {
+	public:
+		// volatility is the standard deviation of the relative price change per tick, e.g. 0.0001 for 0.01%
+		SyntheticRateFeed(const std::map<string, Currency>& currencies, double volatility, uint64_t seed);
+		~SyntheticRateFeed();
+
+		// Row of the rate table the next tick() writes
+		int next_row();
+		void tick(RateTable& rate_table, int64_t last_updated_at);
+		uint64_t tick_count();
+
+	private:
+		std::vector<string> codes;
+		std::vector<double> prices;
+		// Exchange rates per base currency in the shape update_row() expects. Built once and only overwritten afterwards.
+		std::vector<std::map<string, float>> rows;
+		size_t next_base;
+		uint64_t ticks;
+		std::mt19937_64 random;
+		std::normal_distribution<double> step;
+	};
+
+	// Currencies with made up codes ("AAA", "AAB", ...) for benchmarks that shouldn't need the api
+	std::map<string, Currency> make_synthetic_currencies(uint32_t count);
+}
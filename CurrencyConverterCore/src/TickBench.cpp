@@ -0,0 +1,293 @@
+#include "TickBench.h"
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <iomanip>
+#include <windows.h>
+
+#include "RateTable.h"
+#include "SyntheticRateFeed.h"
+#include "AuditLog.h"
+#include "RateAnalytics.h"
+
+namespace CurrencyConverter
+{
+	// Publish times are kept for this many versions per row. Readers that fall further behind report too small latencies.
+	constexpr uint64_t PUBLISH_TIME_SLOTS = 256;
+	// Only every n-th conversion gets timed because reading the clock costs more than the conversion itself
+	constexpr uint64_t CONVERSION_SAMPLE_INTERVAL = 16;
+
+	TickBenchOptions::TickBenchOptions()
+	{
+		this->currency_count = 32;
+		this->ticks_per_second = 100000;
+		this->reader_count = 4;
+		this->seconds = 5.0;
+		this->volatility = 0.0001;
+		this->seed = 42;
+		this->audit_directory = "";
+		this->analytics = false;
+	}
+
+	static int64_t now_nanoseconds()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	// Everything one reader thread produces. Aligned so that readers don't share cache lines.
+	struct alignas(64) ReaderResult {
+		uint64_t conversions;
+		// Keeps the compiler from optimizing the conversions away
+		double checksum;
+		LatencyHistogram visible_latency;
+		LatencyHistogram conversion_duration;
+	};
+
+	static void run_reader(RateTable& rate_table, const std::vector<string>& codes, AuditLog* audit_log, const std::atomic<int64_t>* published_at, const std::atomic<bool>& stop, uint64_t seed, ReaderResult& result)
+	{
+		uint32_t currency_count = (uint32_t)codes.size();
+
+		// Versions this reader saw last per row. Only changes after this count as updates.
+		std::vector<uint64_t> seen_versions(currency_count);
+		for (uint32_t row = 0; row < currency_count; row++)
+		{
+			seen_versions[row] = rate_table.row_version((int)row);
+		}
+
+		// xorshift is enough to pick pairs and much cheaper than the standard engines
+		uint64_t state = seed | 1;
+		while (!stop.load(std::memory_order_relaxed))
+		{
+			state ^= state << 13;
+			state ^= state >> 7;
+			state ^= state << 17;
+			int from = (int)(state % currency_count);
+			int to = (int)((state >> 32) % currency_count);
+
+			uint64_t version = rate_table.row_version(from);
+			bool timed = result.conversions % CONVERSION_SAMPLE_INTERVAL == 0;
+			int64_t started = timed ? now_nanoseconds() : 0;
+
+			double rate = 0.0;
+			if (rate_table.get_rate(from, to, rate))
+			{
+				result.checksum += 100.0 * rate;
+				// Same record convert_money() writes
+				if (audit_log != nullptr)
+				{
+					audit_log->record(codes[from], codes[to], 100.0, rate, 0, 100.0 * rate);
+				}
+			}
+			result.conversions++;
+
+			if (timed)
+			{
+				result.conversion_duration.record((uint64_t)(now_nanoseconds() - started));
+			}
+			if (version != seen_versions[from] && (version & 1) == 0)
+			{
+				int64_t published = published_at[(uint64_t)from * PUBLISH_TIME_SLOTS + (version / 2) % PUBLISH_TIME_SLOTS].load(std::memory_order_relaxed);
+				int64_t latency = now_nanoseconds() - published;
+				result.visible_latency.record(latency > 0 ? (uint64_t)latency : 0);
+				seen_versions[from] = version;
+			}
+		}
+	}
+
+	void run_tick_bench(const TickBenchOptions& options, TickBenchReport& report)
+	{
+		report.options = options;
+		report.ticks = 0;
+		report.conversions = 0;
+		report.update_duration.clear();
+		report.visible_latency.clear();
+		report.conversion_duration.clear();
+		report.audited_conversions = 0;
+		report.lost_audit_records = 0;
+		report.analytics_pairs = 0;
+
+		uint32_t currency_count = options.currency_count;
+		if (currency_count < 2)
+		{
+			currency_count = 2;
+		}
+		if (currency_count > RATE_TABLE_MAX_CURRENCIES)
+		{
+			currency_count = RATE_TABLE_MAX_CURRENCIES;
+		}
+		report.options.currency_count = currency_count;
+
+		// Same steps as at startup: currency list first, then one row of rates per base currency
+		std::unique_ptr<RateTable> rate_table = std::make_unique<RateTable>();
+		std::unique_ptr<RateAnalytics> analytics = nullptr;
+		if (options.analytics)
+		{
+			analytics = std::make_unique<RateAnalytics>();
+			analytics->set_windows(TICK_BENCH_ANALYTICS_WINDOWS);
+			RateAnalytics* subscriber = analytics.get();
+			rate_table->subscribe([subscriber](const string& base_code, const std::map<string, float>& exchange_rates, int64_t last_updated_at) {
+				subscriber->update(base_code, exchange_rates, last_updated_at);
+			});
+		}
+		std::map<string, Currency> currencies = make_synthetic_currencies(currency_count);
+		rate_table->set_currencies(currencies);
+		SyntheticRateFeed feed(currencies, options.volatility, options.seed);
+		// Simulated time of the rates. One second per tick, so that the analytics take every tick as a new update.
+		int64_t last_updated_at = (int64_t)time(nullptr);
+		for (uint32_t i = 0; i < currency_count; i++)
+		{
+			feed.tick(*rate_table, ++last_updated_at);
+		}
+
+		// Rows and columns of the rate table are in code order, like the map
+		std::vector<string> codes {};
+		for (auto& element : currencies)
+		{
+			codes.push_back(element.first);
+		}
+
+		std::unique_ptr<AuditLog> audit_log = nullptr;
+		if (!options.audit_directory.empty())
+		{
+			AuditLogOptions audit_options = AuditLogOptions();
+			audit_options.directory = options.audit_directory;
+			audit_log = std::make_unique<AuditLog>();
+			if (!audit_log->open(audit_options))
+			{
+				audit_log = nullptr;
+			}
+		}
+
+		std::unique_ptr<std::atomic<int64_t>[]> published_at(new std::atomic<int64_t>[currency_count * PUBLISH_TIME_SLOTS]);
+		for (uint64_t i = 0; i < currency_count * PUBLISH_TIME_SLOTS; i++)
+		{
+			published_at[i].store(0, std::memory_order_relaxed);
+		}
+
+		std::atomic<bool> stop = false;
+		std::vector<ReaderResult> results(options.reader_count);
+		std::vector<std::thread> readers {};
+		for (uint32_t i = 0; i < options.reader_count; i++)
+		{
+			results[i].conversions = 0;
+			results[i].checksum = 0.0;
+			readers.emplace_back(run_reader, std::ref(*rate_table), std::cref(codes), audit_log.get(), published_at.get(), std::cref(stop), options.seed + i + 1, std::ref(results[i]));
+		}
+
+		// The writer runs on this thread
+		int64_t started = now_nanoseconds();
+		int64_t duration = (int64_t)(options.seconds * 1e9);
+		int64_t now = started;
+		while (now - started < duration)
+		{
+			if (options.ticks_per_second > 0)
+			{
+				// Ticks are due at fixed points in time. A writer that falls behind doesn't wait, which shows up as a lower tick rate.
+				int64_t due = started + (int64_t)((double)report.ticks * 1e9 / (double)options.ticks_per_second);
+				if (now < due)
+				{
+					YieldProcessor();
+					now = now_nanoseconds();
+					continue;
+				}
+			}
+
+			int row = feed.next_row();
+			uint64_t next_version = rate_table->row_version(row) + 2;
+			published_at[(uint64_t)row * PUBLISH_TIME_SLOTS + (next_version / 2) % PUBLISH_TIME_SLOTS].store(now, std::memory_order_relaxed);
+
+			feed.tick(*rate_table, ++last_updated_at);
+
+			int64_t finished = now_nanoseconds();
+			report.update_duration.record((uint64_t)(finished - now));
+			report.ticks++;
+			now = finished;
+		}
+		report.elapsed_seconds = (double)(now - started) / 1e9;
+
+		stop.store(true, std::memory_order_relaxed);
+		for (auto& reader : readers)
+		{
+			reader.join();
+		}
+		if (audit_log != nullptr)
+		{
+			// Waits for the flusher to write everything
+			audit_log->close();
+			report.audited_conversions = audit_log->written_count();
+			report.lost_audit_records = audit_log->lost_count();
+		}
+		if (analytics != nullptr)
+		{
+			report.analytics_pairs = analytics->pair_count();
+		}
+		for (auto& result : results)
+		{
+			report.conversions += result.conversions;
+			report.visible_latency.merge(result.visible_latency);
+			report.conversion_duration.merge(result.conversion_duration);
+		}
+	}
+
+	void write_tick_bench_report(std::ostream& stream, const TickBenchReport& report)
+	{
+		double seconds = report.elapsed_seconds > 0.0 ? report.elapsed_seconds : 1.0;
+		std::ios_base::fmtflags flags = stream.flags();
+		std::streamsize precision = stream.precision();
+
+		stream << "---------- Rate table micro-benchmark ----------" << '\n';
+		stream << "Readers use the lock free RateTable::get_rate(), not convert_money()." << '\n';
+		stream << report.options.currency_count << " currencies, " << report.options.reader_count << " readers, ";
+		if (report.options.ticks_per_second > 0)
+		{
+			stream << "target " << report.options.ticks_per_second << " ticks/s";
+		}
+		else
+		{
+			stream << "unthrottled";
+		}
+		stream << ", " << std::fixed << std::setprecision(1) << report.elapsed_seconds << "s" << '\n';
+
+		stream << "Ticks:            " << report.ticks << " (" << std::setprecision(0) << (double)report.ticks / seconds << "/s)";
+		if (report.options.ticks_per_second > 0 && (double)report.ticks / seconds < 0.95 * (double)report.options.ticks_per_second)
+		{
+			// The writer couldn't keep up, so the update path is saturated at this rate
+			stream << " SATURATED";
+		}
+		stream << '\n';
+		stream << "Update duration:  ";
+		report.update_duration.write_summary(stream);
+		stream << '\n';
+		stream << "Update visible:   ";
+		report.visible_latency.write_summary(stream);
+		stream << '\n';
+		stream << "Conversions:      " << report.conversions << " (" << (double)report.conversions / seconds << "/s";
+		if (report.options.reader_count > 0)
+		{
+			stream << ", " << (double)report.conversions / seconds / report.options.reader_count << "/s per reader";
+		}
+		stream << ")" << '\n';
+		stream << "Conversion:       ";
+		report.conversion_duration.write_summary(stream);
+		stream << '\n';
+		if (!report.options.audit_directory.empty())
+		{
+			stream << "Audit log:        " << report.audited_conversions << " written, " << report.lost_audit_records << " lost" << '\n';
+		}
+		if (report.options.analytics)
+		{
+			stream << "Analytics:        " << report.analytics_pairs << " pairs, windows";
+			for (auto window : TICK_BENCH_ANALYTICS_WINDOWS)
+			{
+				stream << ' ' << format_window(window);
+			}
+			stream << " of simulated time (1s per tick)" << '\n';
+		}
+
+		stream.flags(flags);
+		stream.precision(precision);
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <ostream>
+
+#include "LatencyHistogram.h"
+
+namespace CurrencyConverter
+{
+	struct TickBenchOptions {
+		TickBenchOptions();
+
+		uint32_t currency_count;
+		// 0 publishes ticks as fast as the writer can
+		uint64_t ticks_per_second;
+		uint32_t reader_count;
+		double seconds;
+		double volatility;
+		uint64_t seed;
+		// Readers write every conversion to an audit log in this directory. Empty for no audit log.
+		std::string audit_directory;
+		// The writer feeds every tick into RateAnalytics as well, like AppState does with fetched rates
+		bool analytics;
+	};
+
+	// Windows of the analytics in the benchmark. Rates carry a simulated time that advances one second per tick,
+	// so these hold a few hundred updates per pair, like a day of real rates would with the default windows.
+	inline const std::vector<int64_t> TICK_BENCH_ANALYTICS_WINDOWS = { 60, 60 * 60 };
+
+	struct TickBenchReport {
+		TickBenchOptions options;
+		uint64_t ticks;
+		double elapsed_seconds;
+		uint64_t conversions;
+		// Time the writer spends in RateTable::update_row() per tick, including the analytics if enabled
+		LatencyHistogram update_duration;
+		// From the start of an update until a reader converting with that row sees the new rates.
+		// Includes the time until the reader happens to pick that row again.
+		LatencyHistogram visible_latency;
+		// Sampled: every 16th conversion of every reader
+		LatencyHistogram conversion_duration;
+		// Only with an audit log
+		uint64_t audited_conversions;
+		uint64_t lost_audit_records;
+		// Only with analytics
+		uint64_t analytics_pairs;
+	};
+
+	// Micro-benchmark of the rate table's seqlocks without network.
+	// A SyntheticRateFeed publishes ticks into a heap backed RateTable at the requested rate
+	// while reader_count threads read random pairs with RateTable::get_rate() as fast as they can.
+	// That is the lock free path of SharedRatesReader, not convert_money(): AppState isn't thread safe,
+	// so conversions through it can't run next to the writer. The writer side is the production one,
+	// update_row() plus (with options.analytics) the RateAnalytics subscriber AppState registers.
+	// Takes options.seconds to run. The report is big, so it is filled in place.
+	void run_tick_bench(const TickBenchOptions& options, TickBenchReport& report);
+
+	void write_tick_bench_report(std::ostream& stream, const TickBenchReport& report);
+}
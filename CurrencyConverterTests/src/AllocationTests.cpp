@@ -0,0 +1,93 @@
+#include "Tests.h"
+#include <filesystem>
+#include <string>
+#include <map>
+#include <ctime>
+
+#include "AppState.h"
+#include "Core.h"
+#include "AllocationTracker.h"
+#include "AuditLog.h"
+#include "SyntheticRateFeed.h"
+
+using namespace CurrencyConverter;
+
+// Currencies with two rounds of rates an hour apart, so that the rate analytics have an average for every pair
+static void load_rates(AppState& app_state, int64_t now)
+{
+	app_state.currencies = make_synthetic_currencies(8);
+	app_state.rate_table.set_currencies(app_state.currencies);
+
+	for (int64_t round = 0; round < 2; round++)
+	{
+		int64_t updated_at = now - 3600 + round * 3600;
+		double base_price = 1.0;
+		for (auto& element : app_state.currencies)
+		{
+			Currency& currency = element.second;
+			double price = 1.0;
+			for (auto& other : app_state.currencies)
+			{
+				currency.exchange_rates[other.first] = (float)((base_price / price) * (1.0 + 0.01 * (double)round));
+				price += 0.5;
+			}
+			currency.rates_updated_at = updated_at;
+			app_state.rate_table.update_row(currency.code, currency.exchange_rates, updated_at);
+			base_price += 0.5;
+		}
+	}
+}
+
+// Budget of the conversion path: with warm rates convert_money() mustn't touch the heap,
+// neither for spot rates nor for averages nor while writing to the audit log.
+TEST(convert_money_does_not_allocate)
+{
+	if (!allocation_tracking_enabled())
+	{
+		CurrencyConverterTests::report_skipped("Allocation tracking is only compiled into the Instrumented configuration");
+		return;
+	}
+
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "CurrencyConverterTests-allocations";
+	std::filesystem::remove_all(directory);
+
+	AppState app_state;
+	load_rates(app_state, (int64_t)time(nullptr));
+	string source = app_state.currencies.begin()->first;
+	string target = app_state.currencies.rbegin()->first;
+	int64_t window = app_state.rate_analytics.get_windows().front();
+
+	AuditLogOptions options;
+	options.directory = directory.string();
+	AuditLog audit_log;
+	CHECK(audit_log.open(options));
+
+	// The first record of a thread allocates its ring buffer
+	app_state.audit_log = &audit_log;
+	convert_money(app_state, source, target, 1.0);
+	app_state.audit_log = nullptr;
+
+	{
+		AllocationBudget budget;
+		convert_money(app_state, source, target, 100.0);
+		CHECK(budget.within(0));
+	}
+	{
+		AllocationBudget budget;
+		convert_money(app_state, source, target, 100.0, window);
+		CHECK(budget.within(0));
+	}
+	app_state.audit_log = &audit_log;
+	{
+		AllocationBudget budget;
+		for (int i = 0; i < 1000; i++)
+		{
+			convert_money(app_state, source, target, 100.0 + i, i % 2 == 0 ? 0 : window);
+		}
+		CHECK(budget.within(0));
+	}
+	app_state.audit_log = nullptr;
+
+	audit_log.close();
+	std::filesystem::remove_all(directory);
+}
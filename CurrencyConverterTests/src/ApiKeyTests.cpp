@@ -0,0 +1,39 @@
+#include "Tests.h"
+
+#include "AppState.h"
+#include "Core.h"
+
+using namespace CurrencyConverter;
+
+TEST(fail_over_of_a_rejected_key_only_marks_it)
+{
+	AppState app_state;
+	app_state.api_keys.add_all("first,second");
+	ApiKey& first = app_state.api_keys.keys[0];
+	ApiKey& second = app_state.api_keys.keys[1];
+
+	CHECK(fail_over_api_key(app_state, first, 429));
+	CHECK(first.state == ApiKeyState::RateLimited);
+	CHECK(second.state == ApiKeyState::Active);
+
+	// Another response of the same key. Nothing left to mark and no other key gets used for it.
+	uint64_t last_used = second.last_used;
+	CHECK(fail_over_api_key(app_state, first, 429));
+	CHECK(second.last_used == last_used);
+
+	// Other responses aren't a reason to switch keys
+	CHECK(!fail_over_api_key(app_state, second, 500));
+	CHECK(acquire_api_key(app_state) == &second);
+}
+
+TEST(acquire_api_key_returns_null_without_usable_keys)
+{
+	AppState app_state;
+	app_state.api_keys.add_all("first,second");
+
+	CHECK(fail_over_api_key(app_state, app_state.api_keys.keys[0], 401));
+	CHECK(!fail_over_api_key(app_state, app_state.api_keys.keys[1], 429));
+	CHECK(!fail_over_api_key(app_state, app_state.api_keys.keys[0], 401));
+	CHECK(app_state.api_keys.active_count() == 0);
+	CHECK(acquire_api_key(app_state) == nullptr);
+}
@@ -0,0 +1,221 @@
+#include "Tests.h"
+#include <filesystem>
+#include <format>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <map>
+
+#include "AppState.h"
+#include "AuditLog.h"
+#include "Core.h"
+
+using namespace CurrencyConverter;
+
+struct ExpectedRecord {
+	string source;
+	string target;
+	double amount;
+	double rate;
+	int64_t rate_updated_at;
+	double result;
+	int64_t rate_window_seconds;
+};
+
+// Everything of a csv line except the time
+static string format_expected(const ExpectedRecord& record, const string& rates_of)
+{
+	string window = record.rate_window_seconds == 0 ? "" : record.rate_window_seconds == 60 * 60 ? "1h" : "1d";
+	return std::format("{},{},{},{},{},{},{}", record.source, record.target, record.amount, record.rate, rates_of, record.result, window);
+}
+
+TEST(audit_log_decodes_what_was_recorded)
+{
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "CurrencyConverterTests-audit";
+	std::filesystem::remove_all(directory);
+
+	// Repeated pairs and rates, results that aren't the product, no rate timestamp, latest and average rates: every kind of record.
+	// Small files, so that records get split over several of them.
+	const char* codes[] = { "EUR", "USDT", "MATIC", "USDC" };
+	std::vector<ExpectedRecord> expected {};
+	for (int i = 0; i < 500; i++)
+	{
+		ExpectedRecord record {};
+		record.source = codes[(i / 7) % 4];
+		record.target = codes[(i / 7 + 1) % 4];
+		record.rate = 1.0 + (double)((i / 11) % 5) / 8.0;
+		record.rate_updated_at = (i / 11) % 4 == 0 ? 0 : 1700000000 + (i / 11) * 60;
+		record.amount = 0.5 + (double)i * 3.25;
+		record.result = i % 13 == 0 ? 1.0 / 3.0 : record.amount * record.rate;
+		int64_t windows[] = { 0, 60 * 60, 24 * 60 * 60 };
+		record.rate_window_seconds = windows[(i / 5) % 3];
+		expected.push_back(record);
+	}
+
+	AuditLogOptions options;
+	options.directory = directory.string();
+	options.max_file_bytes = 1024;
+	AuditLog audit_log;
+	CHECK(audit_log.open(options));
+	for (auto& record : expected)
+	{
+		audit_log.record(record.source, record.target, record.amount, record.rate, record.rate_updated_at, record.result, record.rate_window_seconds);
+	}
+	audit_log.close();
+	CHECK(audit_log.written_count() == expected.size());
+	CHECK(audit_log.lost_count() == 0);
+	CHECK(audit_log.file_count() > 1);
+
+	std::stringstream decoded;
+	CHECK(decode_audit_log(directory.string(), decoded, AuditFormat::Csv));
+	string line = "";
+	std::getline(decoded, line);
+	CHECK(line == "time,source,target,amount,rate,rates_updated_at,result,rate_window");
+	size_t count = 0;
+	while (std::getline(decoded, line))
+	{
+		if (count < expected.size())
+		{
+			ExpectedRecord& record = expected[count];
+			// 1700000000 is 2023-11-14T22:13:20Z
+			int64_t minutes = record.rate_updated_at == 0 ? 0 : (record.rate_updated_at - 1700000000) / 60;
+			string rates_of = record.rate_updated_at == 0 ? "" : std::format("2023-11-14T{:02}:{:02}:20Z", 22 + (13 + minutes) / 60, (13 + minutes) % 60);
+			size_t time_end = line.find(',');
+			CHECK(time_end != string::npos && line.substr(time_end + 1) == format_expected(record, rates_of));
+		}
+		count++;
+	}
+	CHECK(count == expected.size());
+	std::filesystem::remove_all(directory);
+}
+
+// Codes that don't fit are marked instead of passing for another currency
+TEST(audit_log_marks_codes_that_were_cut)
+{
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "CurrencyConverterTests-audit-cut";
+	std::filesystem::remove_all(directory);
+
+	AuditLogOptions options;
+	options.directory = directory.string();
+	AuditLog audit_log;
+	CHECK(audit_log.open(options));
+	audit_log.record("TOOLONGCODE", "EUR", 2.0, 1.5, 0, 3.0);
+	audit_log.record("TOOLONGCODE", "EUR", 4.0, 1.5, 0, 6.0);
+	audit_log.record("TOOLONG", "EUR", 2.0, 1.5, 0, 3.0);
+	audit_log.record("EUR", "TOOLONGCODE", 2.0, 1.5, 0, 3.0);
+	audit_log.close();
+
+	std::stringstream decoded;
+	CHECK(decode_audit_log(directory.string(), decoded, AuditFormat::Csv));
+	std::vector<string> lines {};
+	string line = "";
+	while (std::getline(decoded, line))
+	{
+		size_t time_end = line.find(',');
+		lines.push_back(time_end == string::npos ? line : line.substr(time_end + 1));
+	}
+	CHECK(lines.size() == 5);
+	if (lines.size() == 5)
+	{
+		CHECK(lines[1] == "TOOLONG...,EUR,2,1.5,,3,");
+		CHECK(lines[2] == "TOOLONG...,EUR,4,1.5,,6,");
+		CHECK(lines[3] == "TOOLONG,EUR,2,1.5,,3,");
+		CHECK(lines[4] == "EUR,TOOLONG...,2,1.5,,3,");
+	}
+	std::filesystem::remove_all(directory);
+}
+
+// Conversions at an average rate say so, with the window and the time the average was taken at
+TEST(audit_log_records_the_window_of_average_rates)
+{
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "CurrencyConverterTests-audit-average";
+	std::filesystem::remove_all(directory);
+
+	AppState app_state;
+	app_state.currencies["EUR"] = Currency("", "Euro", "", 2, 0, "EUR", "Euros");
+	app_state.currencies["USD"] = Currency("", "US Dollar", "", 2, 0, "USD", "US dollars");
+	app_state.rate_table.set_currencies(app_state.currencies);
+	// 1700000000 is 2023-11-14T22:13:20Z
+	std::map<string, float> rates = { { "EUR", 1.0f }, { "USD", 1.0f } };
+	app_state.rate_table.update_row("EUR", rates, 1700000000 - 1800);
+	rates["USD"] = 2.0f;
+	app_state.rate_table.update_row("EUR", rates, 1700000000 - 900);
+	app_state.currencies["EUR"].exchange_rates = rates;
+	app_state.currencies["EUR"].rates_updated_at = 1700000000 - 900;
+	app_state.replayed_time = 1700000000;
+
+	AuditLogOptions options;
+	options.directory = directory.string();
+	AuditLog audit_log;
+	CHECK(audit_log.open(options));
+	app_state.audit_log = &audit_log;
+	CHECK(convert_money(app_state, "EUR", "USD", 10.0) == 20.0);
+	// Half of the covered half hour at 1, the other half at 2
+	CHECK(convert_money(app_state, "EUR", "USD", 10.0, 60 * 60) == 15.0);
+	app_state.audit_log = nullptr;
+	audit_log.close();
+
+	std::stringstream decoded;
+	CHECK(decode_audit_log(directory.string(), decoded, AuditFormat::Csv));
+	std::vector<string> lines {};
+	string line = "";
+	while (std::getline(decoded, line))
+	{
+		size_t time_end = line.find(',');
+		lines.push_back(time_end == string::npos ? line : line.substr(time_end + 1));
+	}
+	CHECK(lines.size() == 3);
+	if (lines.size() == 3)
+	{
+		CHECK(lines[1] == "EUR,USD,10,2,2023-11-14T21:58:20Z,20,");
+		CHECK(lines[2] == "EUR,USD,10,1.5,2023-11-14T22:13:20Z,15,1h");
+	}
+
+	std::stringstream text;
+	CHECK(decode_audit_log(directory.string(), text, AuditFormat::Text));
+	CHECK(text.str().find("10 EUR = 15 USD  1h average rate 1.5 until 2023-11-14T22:13:20Z") != string::npos);
+	std::filesystem::remove_all(directory);
+}
+
+// A thread keeps one ring per log, no matter how often it switches between logs
+TEST(audit_log_records_of_a_thread_alternating_between_logs)
+{
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "CurrencyConverterTests-audit-logs";
+	std::filesystem::remove_all(directory);
+
+	// More logs than a thread remembers rings for
+	std::vector<std::unique_ptr<AuditLog>> audit_logs {};
+	for (int i = 0; i < 12; i++)
+	{
+		AuditLogOptions options;
+		options.directory = (directory / std::to_string(i)).string();
+		audit_logs.push_back(std::make_unique<AuditLog>());
+		CHECK(audit_logs.back()->open(options));
+	}
+	for (int round = 0; round < 100; round++)
+	{
+		for (auto& audit_log : audit_logs)
+		{
+			audit_log->record("EUR", "USD", (double)round, 1.1, 0, (double)round * 1.1);
+		}
+	}
+	for (int i = 0; i < 12; i++)
+	{
+		audit_logs[i]->close();
+		CHECK(audit_logs[i]->written_count() == 100);
+		CHECK(audit_logs[i]->lost_count() == 0);
+
+		std::stringstream decoded;
+		CHECK(decode_audit_log((directory / std::to_string(i)).string(), decoded, AuditFormat::Csv));
+		size_t lines = 0;
+		string line = "";
+		while (std::getline(decoded, line))
+		{
+			lines++;
+		}
+		CHECK(lines == 101);
+	}
+	audit_logs.clear();
+	std::filesystem::remove_all(directory);
+}
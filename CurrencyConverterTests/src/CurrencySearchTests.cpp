@@ -0,0 +1,73 @@
+#include "Tests.h"
+#include <string>
+#include <map>
+
+#include "CurrencySearch.h"
+
+using namespace CurrencyConverter;
+
+static std::map<string, Currency> make_currencies()
+{
+	std::map<string, Currency> currencies;
+	currencies["AUD"] = Currency("AU$", "Australian Dollar", "$", 2, 0, "AUD", "Australian dollars");
+	currencies["CAD"] = Currency("CA$", "Canadian Dollar", "$", 2, 0, "CAD", "Canadian dollars");
+	currencies["CHF"] = Currency("CHF", "Swiss Franc", "CHF", 2, 0, "CHF", "Swiss francs");
+	currencies["EUR"] = Currency("\xE2\x82\xAC", "Euro", "\xE2\x82\xAC", 2, 0, "EUR", "euros");
+	currencies["GBP"] = Currency("\xC2\xA3", "British Pound Sterling", "\xC2\xA3", 2, 0, "GBP", "British pounds sterling");
+	currencies["JPY"] = Currency("\xC2\xA5", "Japanese Yen", "\xEF\xBF\xA5", 0, 0, "JPY", "Japanese yen");
+	currencies["USD"] = Currency("$", "US Dollar", "$", 2, 0, "USD", "US dollars");
+	return currencies;
+}
+
+TEST(search_finds_currencies_by_code_name_and_symbol)
+{
+	CurrencySearch search;
+	search.build(make_currencies());
+
+	CHECK(search.resolve("chf") == "CHF");
+	CHECK(search.resolve("Swiss  Fr") == "CHF");
+	CHECK(search.resolve("yen") == "JPY");
+	CHECK(search.resolve("swis frank") == "CHF");
+	CHECK(search.resolve("\xE2\x82\xAC") == "EUR");
+	CHECK(search.resolve("pounds") == "GBP");
+	CHECK(search.resolve("zzz") == "");
+	CHECK(search.search("").empty());
+}
+
+TEST(search_ranks_equal_matches_by_code)
+{
+	CurrencySearch search;
+	search.build(make_currencies());
+
+	// "$" is the symbol of USD and the native symbol of AUD and CAD
+	std::vector<SearchMatch> matches = search.search("$");
+	CHECK(matches.size() == 3);
+	CHECK(matches.size() == 3 && matches[0].code == "USD" && matches[1].code == "AUD" && matches[2].code == "CAD");
+	CHECK(search.resolve("dollar") == "");
+	matches = search.search("dollar", 2);
+	CHECK(matches.size() == 2 && matches[0].code == "AUD" && matches[1].code == "CAD");
+}
+
+// Queries reuse the scratch buffers of the index. Nothing of one query may leak into the next one.
+TEST(search_results_do_not_depend_on_previous_queries)
+{
+	CurrencySearch search;
+	search.build(make_currencies());
+
+	std::vector<SearchMatch> first = search.search("dolar");
+	search.search("swiss franc");
+	search.search("$");
+	std::vector<SearchMatch> again = search.search("dolar");
+	CHECK(first.size() == again.size());
+	for (size_t i = 0; i < first.size() && i < again.size(); i++)
+	{
+		CHECK(first[i].code == again[i].code && first[i].score == again[i].score);
+	}
+
+	// A rebuilt index with fewer currencies
+	std::map<string, Currency> currencies = make_currencies();
+	currencies.erase("AUD");
+	currencies.erase("CAD");
+	search.build(currencies);
+	CHECK(search.resolve("dollar") == "USD");
+}
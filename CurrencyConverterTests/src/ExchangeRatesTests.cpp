@@ -0,0 +1,62 @@
+#include "Tests.h"
+#include <string>
+
+#include "AppState.h"
+#include "Core.h"
+#include "SessionTrace.h"
+
+using namespace CurrencyConverter;
+
+static TraceEvent make_response(const string& request, const string& body)
+{
+	TraceEvent event {};
+	event.type = TraceEventType::Response;
+	event.request = request;
+	event.response.response_code = 200;
+	event.response.body = body;
+	return event;
+}
+
+static string currency_json(const string& code)
+{
+	return "\"" + code + "\":{\"symbol\":\"" + code + "\",\"name\":\"" + code + "\",\"symbol_native\":\"" + code
+		+ "\",\"decimal_digits\":2,\"rounding\":0,\"code\":\"" + code + "\",\"name_plural\":\"" + code + "\"}";
+}
+
+// The rates response always had JPY in it. Once JPY is in the currency list it has to be picked up from there,
+// not only after upstream publishes new rates.
+TEST(currencies_added_to_the_list_get_the_cached_rates)
+{
+	string rates = "{\"meta\":{\"last_updated_at\":\"2023-10-19T00:00:00Z\"},\"data\":{\"EUR\":1,\"JPY\":160,\"USD\":1.25}}";
+	SessionTrace trace;
+	trace.started_at = 0;
+	trace.events = {
+		make_response("/currencies", "{\"data\":{" + currency_json("EUR") + "," + currency_json("USD") + "}}"),
+		make_response("/latest?base_currency=EUR", rates),
+		make_response("/currencies", "{\"data\":{" + currency_json("EUR") + "," + currency_json("JPY") + "," + currency_json("USD") + "}}"),
+		make_response("/latest?base_currency=EUR", rates)
+	};
+
+	AppState app_state;
+	app_state.api_keys.add_all("replay");
+	ResponseReplay replay(trace);
+	app_state.response_replay = &replay;
+	app_state.replayed_time = parse_api_timestamp("2023-10-19T00:00:00Z") + 60 * 60;
+
+	get_currencies(app_state, true);
+	get_exchange_rates(app_state, app_state.currencies["EUR"]);
+	CHECK(app_state.currencies["EUR"].exchange_rates.size() == 2);
+	CHECK(rates_cover_currency_list(app_state, app_state.currencies["EUR"]));
+
+	get_currencies(app_state, true);
+	CHECK(app_state.currencies.contains("JPY"));
+	CHECK(!rates_cover_currency_list(app_state, app_state.currencies["EUR"]));
+
+	// Still younger than a day and published at the same time, but without JPY
+	get_exchange_rates(app_state, app_state.currencies["EUR"]);
+	CHECK(app_state.currencies["EUR"].exchange_rates.size() == 3);
+	CHECK(app_state.currencies["EUR"].exchange_rates.contains("JPY") && convert_money(app_state, "EUR", "JPY", 2.0) == 320.0);
+	double rate = 0.0;
+	CHECK(app_state.rate_table.get_rate(app_state.rate_table.index_of("EUR"), app_state.rate_table.index_of("JPY"), rate) && rate == 160.0);
+	CHECK(rates_cover_currency_list(app_state, app_state.currencies["EUR"]));
+}
@@ -0,0 +1,114 @@
+#include "Tests.h"
+#include <random>
+#include <string>
+#include <string_view>
+#include <cmath>
+
+#include "MoneyCodec.h"
+
+using namespace CurrencyConverter;
+
+static bool parses_to(std::string_view text, double expected, char decimal_separator = '.', char grouping_separator = ',')
+{
+	double amount = -1.0;
+	return parse_amount(text, amount, decimal_separator, grouping_separator) == ParseAmountResult::Ok && amount == expected;
+}
+
+static ParseAmountResult parse(std::string_view text)
+{
+	double amount = 0.0;
+	return parse_amount(text, amount);
+}
+
+TEST(parse_amount_accepts_plain_and_grouped_amounts)
+{
+	CHECK(parses_to("1234.5", 1234.5));
+	CHECK(parses_to(" -12 ", -12.0));
+	CHECK(parses_to("+7", 7.0));
+	CHECK(parses_to(".5", 0.5));
+	CHECK(parses_to("1,234.50", 1234.5));
+	CHECK(parses_to("12,345,678", 12345678.0));
+	CHECK(parses_to("999,999.999", 999999.999));
+	CHECK(parses_to("1.234,50", 1234.5, ',', '.'));
+	CHECK(parses_to("1 234 567,5", 1234567.5, ',', ' '));
+}
+
+TEST(parse_amount_rejects_misplaced_grouping_separators)
+{
+	CHECK(parse("1,5") == ParseAmountResult::Invalid);
+	CHECK(parse("1,00.5") == ParseAmountResult::Invalid);
+	CHECK(parse("1,2345") == ParseAmountResult::Invalid);
+	CHECK(parse("1234,567") == ParseAmountResult::Invalid);
+	CHECK(parse("1,234,56") == ParseAmountResult::Invalid);
+	CHECK(parse("1,,234") == ParseAmountResult::Invalid);
+	CHECK(parse(",123") == ParseAmountResult::Invalid);
+	CHECK(parse("123,") == ParseAmountResult::Invalid);
+	CHECK(parse("-,123") == ParseAmountResult::Invalid);
+	CHECK(parse("1.234,5") == ParseAmountResult::Invalid);
+}
+
+TEST(parse_amount_rejects_invalid_input)
+{
+	CHECK(parse("") == ParseAmountResult::Empty);
+	CHECK(parse("  \t") == ParseAmountResult::Empty);
+	CHECK(parse("abc") == ParseAmountResult::Invalid);
+	CHECK(parse("12a") == ParseAmountResult::Invalid);
+	CHECK(parse("1.2.3") == ParseAmountResult::Invalid);
+	CHECK(parse("-") == ParseAmountResult::Invalid);
+	CHECK(parse(".") == ParseAmountResult::Invalid);
+	CHECK(parse("--1") == ParseAmountResult::Invalid);
+	CHECK(parse("1e5") == ParseAmountResult::Invalid);
+	CHECK(parse(std::string(400, '9')) == ParseAmountResult::Invalid);
+}
+
+TEST(format_money_writes_symbol_grouping_and_decimals)
+{
+	char buffer[64];
+	MoneyFormat dollar = make_money_format("$", 2);
+	std::string text(buffer, format_money(buffer, sizeof(buffer), 1234.5, dollar));
+	CHECK(text == "$1,234.50");
+	text = std::string(buffer, format_money(buffer, sizeof(buffer), -0.001, dollar));
+	CHECK(text == "$0.00");
+
+	MoneyFormat franc = make_money_format("CHF", 2);
+	text = std::string(buffer, format_money(buffer, sizeof(buffer), -1234567.891, franc));
+	CHECK(text == "-CHF 1,234,567.89");
+
+	MoneyFormat yen = make_money_format("\xC2\xA5", 0, '.', 0);
+	text = std::string(buffer, format_money(buffer, sizeof(buffer), 1234567.0, yen));
+	CHECK(text == "\xC2\xA5" "1234567");
+
+	CHECK(format_money(buffer, 4, 1234.5, dollar) == 0);
+	CHECK(format_money(buffer, sizeof(buffer), NAN, dollar) == 0);
+}
+
+// Whatever format_money() writes, parse_amount() reads back as the amount rounded to the decimal digits of the currency
+TEST(format_money_and_parse_amount_round_trip)
+{
+	std::mt19937_64 random(42);
+	std::uniform_real_distribution<double> magnitude(-3.0, 12.0);
+	const char separators[][2] = { { '.', ',' }, { ',', '.' }, { '.', 0 }, { ',', ' ' } };
+
+	char buffer[128];
+	for (int i = 0; i < 20000; i++)
+	{
+		uint8_t decimal_digits = (uint8_t)(i % 4);
+		const char* pair = separators[i % 4];
+		MoneyFormat format = make_money_format(i % 2 == 0 ? "$" : "EUR", decimal_digits, pair[0], pair[1]);
+
+		double amount = std::pow(10.0, magnitude(random)) * (i % 3 == 0 ? -1.0 : 1.0);
+		size_t length = format_money(buffer, sizeof(buffer), amount, format);
+		CHECK(length > 0);
+
+		// Everything but the sign and the symbol
+		std::string text(buffer, length);
+		bool negative = text[0] == '-';
+		std::string number = text.substr((negative ? 1 : 0) + format.prefix_length);
+
+		double parsed = 0.0;
+		CHECK(parse_amount(number, parsed, pair[0], pair[1]) == ParseAmountResult::Ok);
+		// Off by at most half of the last digit, plus what a double can't tell apart
+		double tolerance = 0.5 / std::pow(10.0, decimal_digits) + std::abs(amount) * 1e-15;
+		CHECK(std::abs(parsed - std::abs(amount)) <= tolerance);
+	}
+}
@@ -0,0 +1,144 @@
+#include "Tests.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "RateAnalytics.h"
+
+using namespace CurrencyConverter;
+
+struct RateSample {
+	int64_t at;
+	double rate;
+};
+
+// Statistics of the window ending at now, straight from the definitions in RateAnalytics.h
+static RateStatistics brute_force_statistics(const std::vector<RateSample>& history, int64_t window_seconds, int64_t now)
+{
+	int64_t start = now - window_seconds;
+	// The oldest sample that was still in effect at the start of the window
+	size_t first = 0;
+	while (first + 1 < history.size() && history[first + 1].at <= start)
+	{
+		first++;
+	}
+
+	RateStatistics statistics {};
+	int64_t covered_from = std::max(start, history[first].at);
+	double area = 0.0;
+	statistics.min = history[first].rate;
+	statistics.max = history[first].rate;
+	for (size_t i = first; i < history.size(); i++)
+	{
+		int64_t from = std::max(start, history[i].at);
+		int64_t until = i + 1 < history.size() ? history[i + 1].at : now;
+		area += history[i].rate * (double)(until - from);
+		statistics.min = std::min(statistics.min, history[i].rate);
+		statistics.max = std::max(statistics.max, history[i].rate);
+	}
+	statistics.spot = history.back().rate;
+	statistics.samples = history.size() - first;
+	statistics.covered_seconds = now - covered_from;
+	statistics.twap = statistics.covered_seconds > 0 ? area / (double)statistics.covered_seconds : statistics.spot;
+
+	std::vector<double> returns {};
+	for (size_t i = first + 1; i < history.size(); i++)
+	{
+		returns.push_back(std::log(history[i].rate / history[i - 1].rate));
+	}
+	if (returns.size() >= 2)
+	{
+		double mean = 0.0;
+		for (double value : returns)
+		{
+			mean += value;
+		}
+		mean /= (double)returns.size();
+		double variance = 0.0;
+		for (double value : returns)
+		{
+			variance += (value - mean) * (value - mean);
+		}
+		statistics.volatility = std::sqrt(variance / (double)(returns.size() - 1));
+	}
+	return statistics;
+}
+
+static bool is_close(double value, double expected)
+{
+	return std::fabs(value - expected) <= 1e-9 * std::max(1.0, std::fabs(expected));
+}
+
+// Random walks with random gaps between updates and random query times, compared against the brute force computation.
+// Everything is a multiple of 10 minutes, so that updates often fall exactly on the start of a window.
+TEST(rate_analytics_match_brute_force_statistics)
+{
+	std::vector<int64_t> windows = { 60 * 60, 24 * 60 * 60, 7 * 24 * 60 * 60 };
+	RateAnalytics rate_analytics;
+	rate_analytics.set_windows(windows);
+
+	std::mt19937_64 random(7);
+	std::map<string, float> rates = { { "EUR", 1.0f }, { "JPY", 160.0f }, { "USD", 1.08f } };
+	std::map<string, std::vector<RateSample>> history {};
+	int64_t at = 1700000000;
+	size_t mismatches = 0;
+	for (int update = 0; update < 3000; update++)
+	{
+		at += 600 * (1 + (int64_t)(random() % 12));
+		for (auto& element : rates)
+		{
+			// Sometimes the rate stays the same, the running min and max have to keep equal rates apart
+			if (random() % 4 != 0)
+			{
+				element.second *= (float)std::exp(((double)(random() % 2001) - 1000.0) / 100000.0);
+			}
+			history[element.first].push_back({ at, (double)element.second });
+		}
+		rate_analytics.update("EUR", rates, at);
+		// The same rates published again don't count as a new sample
+		if (update % 10 == 0)
+		{
+			rate_analytics.update("EUR", rates, at);
+		}
+
+		if (update % 37 != 0)
+		{
+			continue;
+		}
+		int64_t now = at + 600 * (int64_t)(random() % 8);
+		for (auto& element : rates)
+		{
+			for (int64_t window : windows)
+			{
+				RateStatistics statistics {};
+				CHECK(rate_analytics.get_statistics("EUR", element.first, window, now, statistics));
+				RateStatistics expected = brute_force_statistics(history[element.first], window, now);
+				bool equal = statistics.spot == expected.spot && statistics.min == expected.min && statistics.max == expected.max
+					&& statistics.samples == expected.samples && statistics.covered_seconds == expected.covered_seconds
+					&& is_close(statistics.twap, expected.twap) && is_close(statistics.volatility, expected.volatility);
+				if (!equal)
+				{
+					mismatches++;
+				}
+			}
+		}
+	}
+	CHECK(mismatches == 0);
+}
+
+TEST(rate_analytics_have_no_statistics_for_unknown_windows_and_pairs)
+{
+	RateAnalytics rate_analytics;
+	std::map<string, float> rates = { { "EUR", 1.0f }, { "USD", 1.08f } };
+	rate_analytics.update("EUR", rates, 1700000000);
+
+	RateStatistics statistics {};
+	CHECK(rate_analytics.get_statistics("EUR", "USD", 60 * 60, 1700000000, statistics));
+	CHECK(statistics.twap == (double)1.08f && statistics.samples == 1 && statistics.covered_seconds == 0);
+	CHECK(!rate_analytics.get_statistics("EUR", "USD", 2 * 60 * 60, 1700000000, statistics));
+	CHECK(!rate_analytics.get_statistics("EUR", "JPY", 60 * 60, 1700000000, statistics));
+	CHECK(!rate_analytics.get_statistics("USD", "EUR", 60 * 60, 1700000000, statistics));
+}
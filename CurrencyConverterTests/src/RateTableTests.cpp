@@ -0,0 +1,107 @@
+#include "Tests.h"
+#include <string>
+#include <map>
+#include <cstring>
+
+#include "RateTable.h"
+#include "SyntheticRateFeed.h"
+
+using namespace CurrencyConverter;
+
+TEST(update_row_clears_rates_missing_from_the_update)
+{
+	std::map<string, Currency> currencies = make_synthetic_currencies(4);
+	RateTable rate_table;
+	rate_table.set_currencies(currencies);
+
+	std::map<string, float> rates = { { "AAA", 1.0f }, { "AAB", 2.0f }, { "AAC", 4.0f }, { "AAD", 8.0f } };
+	rate_table.update_row("AAA", rates, 1000);
+
+	double rate = 0.0;
+	CHECK(rate_table.get_rate(rate_table.index_of("AAA"), rate_table.index_of("AAC"), rate) && rate == 4.0);
+	// Crossed over the only fetched row
+	CHECK(rate_table.get_rate(rate_table.index_of("AAB"), rate_table.index_of("AAD"), rate) && rate == 4.0);
+
+	// Upstream stopped quoting AAC
+	rates.erase("AAC");
+	rates["AAD"] = 16.0f;
+	rate_table.update_row("AAA", rates, 2000);
+
+	CHECK(!rate_table.get_rate(rate_table.index_of("AAA"), rate_table.index_of("AAC"), rate));
+	CHECK(!rate_table.get_rate(rate_table.index_of("AAB"), rate_table.index_of("AAC"), rate));
+	CHECK(rate_table.get_rate(rate_table.index_of("AAA"), rate_table.index_of("AAD"), rate) && rate == 16.0);
+	CHECK(rate_table.get_rate(rate_table.index_of("AAB"), rate_table.index_of("AAD"), rate) && rate == 8.0);
+}
+
+// Cut to 3 letters, "USDC" and "USDT" would both end up as a second "USD"
+TEST(rate_table_keeps_codes_longer_than_three_letters_apart)
+{
+	std::map<string, Currency> currencies {};
+	for (const char* code : { "EUR", "MATIC", "USD", "USDC", "USDT", "TOOLONGCODE" })
+	{
+		currencies[code] = Currency("", code, "", 2, 0, code, code);
+	}
+	RateTable rate_table;
+	rate_table.set_currencies(currencies);
+
+	CHECK(rate_table.index_of("USD") >= 0);
+	CHECK(rate_table.index_of("USDC") >= 0 && rate_table.index_of("USDC") != rate_table.index_of("USD"));
+	CHECK(rate_table.index_of("USDT") >= 0 && rate_table.index_of("USDT") != rate_table.index_of("USD") && rate_table.index_of("USDT") != rate_table.index_of("USDC"));
+	CHECK(rate_table.index_of("MATIC") >= 0);
+	CHECK(rate_table.index_of("USDX") < 0);
+	// Doesn't fit, so it isn't in the table at all instead of under a cut off code
+	CHECK(rate_table.index_of("TOOLONGCODE") < 0);
+	CHECK(rate_table.index_of("TOOLONG") < 0);
+
+	std::map<string, float> rates = { { "EUR", 1.0f }, { "MATIC", 2.0f }, { "TOOLONGCODE", 3.0f }, { "USD", 1.25f }, { "USDC", 1.5f }, { "USDT", 1.75f } };
+	rate_table.update_row("EUR", rates, 1000);
+
+	double rate = 0.0;
+	int eur = rate_table.index_of("EUR");
+	CHECK(rate_table.get_rate(eur, rate_table.index_of("USD"), rate) && rate == 1.25);
+	CHECK(rate_table.get_rate(eur, rate_table.index_of("USDC"), rate) && rate == 1.5);
+	CHECK(rate_table.get_rate(eur, rate_table.index_of("USDT"), rate) && rate == 1.75);
+	CHECK(rate_table.get_rate(eur, rate_table.index_of("MATIC"), rate) && rate == 2.0);
+}
+
+// A publisher that died between begin and end of a write leaves the sequence numbers odd for good
+TEST(rate_table_readers_give_up_on_writes_that_never_end)
+{
+	std::map<string, Currency> currencies = make_synthetic_currencies(4);
+	RateTable rate_table;
+	rate_table.set_currencies(currencies);
+	std::map<string, float> rates = { { "AAA", 1.0f }, { "AAB", 2.0f }, { "AAC", 4.0f }, { "AAD", 8.0f } };
+	rate_table.update_row("AAA", rates, 1000);
+
+	RateTableSnapshot* snapshot = new RateTableSnapshot();
+	CHECK(rate_table.snapshot(*snapshot));
+
+	// Same layout a reader in another process maps
+	RateTableLayout* layout = new RateTableLayout();
+	layout->currency_count = snapshot->currency_count;
+	layout->pivot_index = snapshot->pivot_index;
+	memcpy(layout->codes, snapshot->codes, sizeof(layout->codes));
+	memcpy(layout->last_updated_at, snapshot->last_updated_at, sizeof(layout->last_updated_at));
+	memcpy(layout->rates, snapshot->rates, sizeof(layout->rates));
+
+	double rate = 0.0;
+	int from = rate_table_index_of(layout, "AAA");
+	int to = rate_table_index_of(layout, "AAC");
+	CHECK(from >= 0 && to >= 0 && rate_table_get_rate(layout, from, to, rate) && rate == 4.0);
+
+	// Stuck in the middle of a row update
+	layout->row_sequence[from].store(1);
+	CHECK(!rate_table_get_rate(layout, from, to, rate));
+	CHECK(!rate_table_snapshot(layout, *snapshot));
+	CHECK(rate_table_index_of(layout, "AAC") == to);
+	layout->row_sequence[from].store(2);
+
+	// Stuck in the middle of a catalog update
+	layout->catalog_sequence.store(3);
+	CHECK(rate_table_index_of(layout, "AAC") == -1);
+	CHECK(!rate_table_get_rate(layout, from, to, rate));
+	CHECK(!rate_table_snapshot(layout, *snapshot));
+
+	delete layout;
+	delete snapshot;
+}
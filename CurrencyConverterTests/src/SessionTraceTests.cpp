@@ -0,0 +1,85 @@
+#include "Tests.h"
+#include <filesystem>
+#include <string>
+#include <ctime>
+
+#include "AppState.h"
+#include "Core.h"
+#include "SessionTrace.h"
+
+using namespace CurrencyConverter;
+
+static FetchResponse make_rates_response(const string& last_updated_at, double usd_rate)
+{
+	FetchResponse response {};
+	response.response_code = 200;
+	response.body = "{\"meta\":{\"last_updated_at\":\"" + last_updated_at + "\"},\"data\":{\"EUR\":1,\"USD\":" + std::to_string(usd_rate) + "}}";
+	return response;
+}
+
+TEST(trace_keeps_start_time_commands_and_responses)
+{
+	std::filesystem::path path = std::filesystem::temp_directory_path() / "CurrencyConverterTests-session.cctr";
+	int64_t before = (int64_t)time(nullptr);
+	{
+		TraceRecorder recorder;
+		CHECK(recorder.open(path.string()));
+		recorder.record(TraceEventType::Start, { "EUR" });
+		recorder.record_response("/latest?base_currency=EUR", make_rates_response("2023-10-19T23:59:59Z", 1.07));
+		recorder.record(TraceEventType::Convert, { "EUR", "USD", "1h" }, 12.5);
+	}
+
+	SessionTrace trace;
+	CHECK(load_session_trace(path.string(), trace));
+	CHECK(trace.started_at / 1000000 >= before && trace.started_at / 1000000 <= (int64_t)time(nullptr));
+	CHECK(trace.events.size() == 3);
+	if (trace.events.size() == 3)
+	{
+		CHECK(trace.events[0].type == TraceEventType::Start && trace.events[0].codes.size() == 1);
+		CHECK(trace.events[1].type == TraceEventType::Response && trace.events[1].request == "/latest?base_currency=EUR");
+		CHECK(trace.events[1].response.body == make_rates_response("2023-10-19T23:59:59Z", 1.07).body);
+		CHECK(trace.events[2].codes.size() == 3 && trace.events[2].codes[2] == "1h" && trace.events[2].amount == 12.5);
+		CHECK(trace.events[0].at_microseconds <= trace.events[2].at_microseconds);
+	}
+	std::filesystem::remove(path);
+}
+
+// Cached rates expire on the clock of the session, so a replay fetches exactly when the recorded session did
+TEST(replayed_sessions_run_on_the_recorded_clock)
+{
+	SessionTrace trace;
+	trace.started_at = 0;
+	TraceEvent first {};
+	first.type = TraceEventType::Response;
+	first.request = "/latest?base_currency=EUR";
+	first.response = make_rates_response("2023-10-19T00:00:00Z", 1.05);
+	TraceEvent second = first;
+	second.response = make_rates_response("2023-10-20T00:00:00Z", 1.10);
+	trace.events = { first, second };
+
+	AppState app_state;
+	app_state.api_keys.add_all("replay");
+	ResponseReplay replay(trace);
+	app_state.response_replay = &replay;
+	app_state.currencies["EUR"] = Currency("\xE2\x82\xAC", "Euro", "\xE2\x82\xAC", 2, 0, "EUR", "Euros");
+	app_state.currencies["USD"] = Currency("$", "US Dollar", "$", 2, 0, "USD", "US dollars");
+	app_state.rate_table.set_currencies(app_state.currencies);
+
+	int64_t published = parse_api_timestamp("2023-10-19T00:00:00Z");
+	app_state.replayed_time = published + 60 * 60;
+	CHECK(app_state.now() == published + 60 * 60);
+	get_exchange_rates(app_state, app_state.currencies["EUR"]);
+	CHECK(convert_money(app_state, "EUR", "USD", 100.0) == 100.0 * (double)1.05f);
+
+	// Younger than a day on the recorded clock, even though the system clock is years later
+	app_state.replayed_time = published + 12 * 60 * 60;
+	get_exchange_rates(app_state, app_state.currencies["EUR"]);
+	CHECK(convert_money(app_state, "EUR", "USD", 100.0) == 100.0 * (double)1.05f);
+
+	app_state.replayed_time = published + 25 * 60 * 60;
+	get_exchange_rates(app_state, app_state.currencies["EUR"]);
+	CHECK(convert_money(app_state, "EUR", "USD", 100.0) == 100.0 * (double)1.10f);
+
+	app_state.replayed_time = 0;
+	CHECK(app_state.now() >= published + 25 * 60 * 60);
+}
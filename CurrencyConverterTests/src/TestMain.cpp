@@ -0,0 +1,74 @@
+#include "Tests.h"
+#include <iostream>
+#include <string>
+#include <cstdlib>
+
+namespace CurrencyConverterTests
+{
+	// State of the test that is running
+	static uint64_t failed_checks = 0;
+	static bool skipped = false;
+
+	std::vector<TestCase>& get_tests()
+	{
+		// Function local, so that registrations from other files can't run before it exists
+		static std::vector<TestCase> tests;
+		return tests;
+	}
+
+	TestRegistration::TestRegistration(const char* name, TestFunction function)
+	{
+		get_tests().push_back(TestCase { name, function });
+	}
+
+	void report_failure(const char* file, int line, const char* expression)
+	{
+		std::cerr << "\t" << file << "(" << line << "): CHECK(" << expression << ") failed" << '\n';
+		failed_checks++;
+	}
+
+	void report_skipped(const char* reason)
+	{
+		std::cout << "\t" << reason << '\n';
+		skipped = true;
+	}
+}
+
+// Runs every test, or only the tests whose name contains the first argument
+int main(int argc, char* argv[])
+{
+	std::string filter = argc >= 2 ? argv[1] : "";
+	uint32_t passed = 0;
+	uint32_t failed = 0;
+	uint32_t skipped = 0;
+
+	for (auto& test : CurrencyConverterTests::get_tests())
+	{
+		if (std::string(test.name).find(filter) == std::string::npos)
+		{
+			continue;
+		}
+
+		CurrencyConverterTests::failed_checks = 0;
+		CurrencyConverterTests::skipped = false;
+		std::cout << test.name << '\n';
+		test.function();
+
+		if (CurrencyConverterTests::failed_checks > 0)
+		{
+			std::cout << "\tFAILED" << '\n';
+			failed++;
+		}
+		else if (CurrencyConverterTests::skipped)
+		{
+			skipped++;
+		}
+		else
+		{
+			passed++;
+		}
+	}
+
+	std::cout << "\n" << passed << " passed, " << failed << " failed, " << skipped << " skipped" << std::endl;
+	return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
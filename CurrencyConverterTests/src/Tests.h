@@ -0,0 +1,47 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+// Small test harness without dependencies. Every test is a function that reports failed checks with CHECK.
+// Tests register themselves, so a new test file only has to be added to the project.
+//
+//     TEST(parse_amount_rejects_letters)
+//     {
+//         double amount = 0.0;
+//         CHECK(parse_amount("12a", amount) == ParseAmountResult::Invalid);
+//     }
+
+namespace CurrencyConverterTests
+{
+	using TestFunction = void (*)();
+
+	struct TestCase {
+		const char* name;
+		TestFunction function;
+	};
+
+	std::vector<TestCase>& get_tests();
+
+	struct TestRegistration {
+		TestRegistration(const char* name, TestFunction function);
+	};
+
+	// Writes the failed check to the console and marks the running test as failed
+	void report_failure(const char* file, int line, const char* expression);
+	// Marks the running test as skipped, e.g. because the build doesn't support it
+	void report_skipped(const char* reason);
+}
+
+#define TEST(name) \
+	static void name(); \
+	static CurrencyConverterTests::TestRegistration name##_registration(#name, name); \
+	static void name()
+
+#define CHECK(expression) \
+	do \
+	{ \
+		if (!(expression)) \
+		{ \
+			CurrencyConverterTests::report_failure(__FILE__, __LINE__, #expression); \
+		} \
+	} while (false)
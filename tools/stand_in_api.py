@@ -0,0 +1,64 @@
+# Local stand-in for api.freecurrencyapi.com to check conditional requests without using up quota.
+# Usage: python tools/stand_in_api.py [port]
+# Then:  CurrencyConverter.exe <any key> --api-url=http://localhost:8080/v1
+#
+# Every response carries an ETag. Requests with a matching If-None-Match get a 304 with an empty body.
+# The console shows which requests were answered with 200 and which with 304.
+
+import hashlib
+import json
+import sys
+from http.server import BaseHTTPRequestHandler, HTTPServer
+
+CURRENCIES = {
+    "EUR": {"symbol": "€", "name": "Euro", "symbol_native": "€", "decimal_digits": 2, "rounding": 0, "code": "EUR", "name_plural": "Euros"},
+    "JPY": {"symbol": "¥", "name": "Japanese Yen", "symbol_native": "￥", "decimal_digits": 0, "rounding": 0, "code": "JPY", "name_plural": "Japanese yen"},
+    "USD": {"symbol": "$", "name": "US Dollar", "symbol_native": "$", "decimal_digits": 2, "rounding": 0, "code": "USD", "name_plural": "US dollars"},
+}
+USD_RATES = {"EUR": 0.93, "JPY": 149.45, "USD": 1.0}
+LAST_UPDATED_AT = "2023-10-19T23:59:59Z"
+
+
+def rates_for(base):
+    return {code: rate / USD_RATES[base] for code, rate in USD_RATES.items()}
+
+
+class StandInHandler(BaseHTTPRequestHandler):
+    def do_GET(self):
+        path = self.path.split("?")[0]
+        if path.endswith("/status"):
+            body = {"account_id": 1, "quotas": {"month": {"total": 5000, "used": 0, "remaining": 5000}}}
+        elif path.endswith("/currencies"):
+            body = {"data": CURRENCIES}
+        elif path.endswith("/latest"):
+            base = self.headers.get("base_currency", "USD")
+            if base not in USD_RATES:
+                self.send_response(422)
+                self.end_headers()
+                return
+            body = {"meta": {"last_updated_at": LAST_UPDATED_AT}, "data": rates_for(base)}
+        else:
+            self.send_response(404)
+            self.end_headers()
+            return
+
+        encoded = json.dumps(body, ensure_ascii=False).encode("utf-8")
+        etag = '"' + hashlib.sha1(encoded).hexdigest() + '"'
+        if self.headers.get("If-None-Match") == etag:
+            self.send_response(304)
+            self.send_header("ETag", etag)
+            self.end_headers()
+            return
+
+        self.send_response(200)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("ETag", etag)
+        self.send_header("Content-Length", str(len(encoded)))
+        self.end_headers()
+        self.wfile.write(encoded)
+
+
+if __name__ == "__main__":
+    port = int(sys.argv[1]) if len(sys.argv) > 1 else 8080
+    print(f"Stand-in api listening on http://localhost:{port}/v1")
+    HTTPServer(("localhost", port), StandInHandler).serve_forever()